@@ -31,17 +31,25 @@ namespace jade {
 		static const jade::Player& ConstPlayer();
 
 	public:
-		void MainLoop();
+		// Returns the exit code once the application has stopped
+		int MainLoop();
 		void CloseRequest();
 		void CloseUnsavedRequest();
 
+		inline void SetExitCode(int exitCode) noexcept { m_exitCode = exitCode; }
+
+	private:
+		Timestep _NextWakeupTimeout() const noexcept;
+
 	private:
 		uint32_t	 m_states = 0;
+		int          m_exitCode = 0;
 		IBackend*    m_backend = nullptr;
-		jade::Player m_player;
 		EventSystem  m_eventSystem;
+		jade::Player m_player;
 		InputSystem  m_inputSystem;
 		MusicLibrary m_musicLibrary;
+		ThreadPool   m_threadPool;
 	};
 }
 
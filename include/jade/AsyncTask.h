@@ -0,0 +1,285 @@
+#ifndef JADE_ASYNC_TASK_HEADER
+#define JADE_ASYNC_TASK_HEADER
+
+#include <jade/Core.h>
+#include <jade/Event.h>
+#include <jade/EventSystem.h>
+
+#include <future>
+#include <memory>
+#include <utility>
+#include <optional>
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+
+namespace jade {
+	// Thrown into a coroutine at a co_await once its cancellation token is cancelled
+	class TaskCancelled : public std::exception {
+	public:
+		virtual const char* what() const noexcept override { return "Task has been cancelled"; }
+	};
+
+	template <typename T = void>
+	class AsyncTask;
+}
+
+namespace _jade {
+	template <typename T>
+	struct IsAsyncTask : std::false_type {};
+
+	template <typename T>
+	struct IsAsyncTask<jade::AsyncTask<T>> : std::true_type {};
+
+	class AsyncTaskPromiseBase {
+	public:
+		struct FinalAwaiter {
+			bool await_ready() const noexcept { return false; }
+
+			template <typename Promise>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+				handle.promise().isFinished = true;
+				std::coroutine_handle<> continuation = handle.promise().continuation;
+				return continuation ? continuation : std::noop_coroutine();
+			}
+
+			void await_resume() const noexcept {}
+		};
+
+	public:
+		std::suspend_always initial_suspend() const noexcept { return {}; }
+		FinalAwaiter final_suspend() const noexcept { return {}; }
+
+		void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+		// Every co_await inside the coroutine is a cancellation checkpoint, awaited
+		// tasks inherit the token
+		template <typename Awaitable>
+		Awaitable&& await_transform(Awaitable&& awaitable) {
+			if (token.IsCancelled()) {
+				throw jade::TaskCancelled();
+			}
+			if constexpr (IsAsyncTask<std::remove_cvref_t<Awaitable>>::value) {
+				awaitable.SetCancellationToken(token);
+			}
+			return std::forward<Awaitable>(awaitable);
+		}
+
+	public:
+		std::coroutine_handle<> continuation;
+		std::exception_ptr      exception;
+		jade::CancellationToken token;
+		bool                    isFinished = false;
+	};
+
+	template <typename T>
+	class AsyncTaskPromise : public AsyncTaskPromiseBase {
+	public:
+		template <typename U>
+		void return_value(U&& value) { result.emplace(std::forward<U>(value)); }
+
+		T GetResult() {
+			if (exception) {
+				std::rethrow_exception(exception);
+			}
+			return std::move(*result);
+		}
+
+	public:
+		std::optional<T> result;
+	};
+
+	template <>
+	class AsyncTaskPromise<void> : public AsyncTaskPromiseBase {
+	public:
+		void return_void() const noexcept {}
+
+		void GetResult() {
+			if (exception) {
+				std::rethrow_exception(exception);
+			}
+		}
+	};
+
+	// Self-destroying coroutine that drives a launched AsyncTask to completion
+	struct DetachedTask {
+		struct promise_type {
+			DetachedTask get_return_object() const noexcept { return {}; }
+			std::suspend_never initial_suspend() const noexcept { return {}; }
+			std::suspend_never final_suspend() const noexcept { return {}; }
+			void return_void() const noexcept {}
+			void unhandled_exception() const noexcept { std::terminate(); }
+		};
+	};
+}
+
+namespace jade {
+	// Lazily started coroutine. It runs when awaited or launched and resumes the
+	// awaiting coroutine on whichever thread it finishes on.
+	template <typename T>
+	class AsyncTask {
+	public:
+		struct promise_type : _jade::AsyncTaskPromise<T> {
+			AsyncTask get_return_object() noexcept {
+				return AsyncTask(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+
+			// A frame destroyed before it finished, e.g. with an OnCoroutineResume that was
+			// never dispatched, destroys the coroutine awaiting it as well. A Launch() frame
+			// at the top breaks its promise, so whoever waits on the future wakes up.
+			~promise_type() {
+				if (!this->isFinished && this->continuation) {
+					owner->m_handle = nullptr;
+					this->continuation.destroy();
+				}
+			}
+
+			AsyncTask* owner = nullptr;
+		};
+
+	public:
+		AsyncTask(AsyncTask&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+		AsyncTask& operator=(AsyncTask&& other) noexcept {
+			if (this != &other) {
+				_Destroy();
+				m_handle = std::exchange(other.m_handle, nullptr);
+			}
+			return *this;
+		}
+
+		AsyncTask(const AsyncTask&) = delete;
+		AsyncTask& operator=(const AsyncTask&) = delete;
+
+		~AsyncTask() {
+			_Destroy();
+		}
+
+	public:
+		inline void SetCancellationToken(const CancellationToken& token) { m_handle.promise().token = token; }
+
+		bool await_ready() const noexcept { return false; }
+
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+			m_handle.promise().continuation = continuation;
+			m_handle.promise().owner = this;
+			return m_handle;
+		}
+
+		T await_resume() { return m_handle.promise().GetResult(); }
+
+	private:
+		explicit AsyncTask(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+		// Called from the awaiting coroutine's own destruction, which must not start
+		// over from the promise
+		void _Destroy() noexcept {
+			if (m_handle) {
+				m_handle.promise().continuation = nullptr;
+				m_handle.destroy();
+			}
+		}
+
+	private:
+		std::coroutine_handle<promise_type> m_handle;
+	};
+
+	// Resumes the coroutine on a thread pool worker
+	struct ResumeOnThreadPool {
+		TaskPriority priority = TaskPriority::Normal;
+
+		bool await_ready() const noexcept { return ThreadPool::Get().IsWorkerThread(); }
+
+		void await_suspend(std::coroutine_handle<> handle) const {
+			ThreadPool::Get().Post([handle]() { handle.resume(); }, priority);
+		}
+
+		void await_resume() const noexcept {}
+	};
+
+	// Resumes the coroutine from EventSystem::Dispatch on the main thread
+	struct ResumeOnMainThread {
+		bool await_ready() const noexcept { return EventSystem::GetConst().IsMainThread(); }
+
+		void await_suspend(std::coroutine_handle<> handle) const {
+			EventEmitter<OnCoroutineResume>().Emit(OnCoroutineResume(handle));
+		}
+
+		void await_resume() const noexcept {}
+	};
+
+	// Awaiting it only checks for cancellation
+	struct CancellationCheckpoint {
+		bool await_ready() const noexcept { return true; }
+		void await_suspend(std::coroutine_handle<>) const noexcept {}
+		void await_resume() const noexcept {}
+	};
+
+	// Starts the task on the calling thread. The future holds its result or exception.
+	template <typename T>
+	std::future<T> Launch(AsyncTask<T> task, const CancellationToken& token = {}) {
+		std::promise<T> promise;
+		std::future<T> future = promise.get_future();
+
+		task.SetCancellationToken(token);
+		[](AsyncTask<T> task, std::promise<T> promise) -> _jade::DetachedTask {
+			try {
+				if constexpr (std::is_void_v<T>) {
+					co_await task;
+					promise.set_value();
+				}
+				else {
+					promise.set_value(co_await task);
+				}
+			}
+			catch (...) {
+				promise.set_exception(std::current_exception());
+			}
+		}(std::move(task), std::move(promise));
+
+		return future;
+	}
+
+	// Starts a library task and reports how it ended through OnAsyncTaskEnded:
+	// TaskCancelled means Cancelled, any other exception means Failed. Only task
+	// types listed as cancellable follow the FutureTask's token.
+	inline std::future<void> Launch(AsyncTask<void> task, TaskType type, const std::shared_ptr<FutureTask>& futureTask) {
+		std::promise<void> promise;
+		std::future<void> future = promise.get_future();
+
+		bool isCancellable = type < TaskType::AsyncCancellableCount;
+		CancellationToken token = futureTask && isCancellable ? futureTask->GetCancellationToken() : CancellationToken();
+		task.SetCancellationToken(token);
+
+		[](AsyncTask<void> task, std::promise<void> promise, TaskType type, std::shared_ptr<FutureTask> futureTask) -> _jade::DetachedTask {
+			OnAsyncTaskEnded ended = {
+				.status   = OnTaskEnded::Status::Success,
+				.whatTask = type,
+				.category = TaskCategory::Async,
+				.task     = futureTask,
+				.errorMsg = {}
+			};
+			try {
+				co_await task;
+			}
+			catch (const TaskCancelled&) {
+				ended.status = OnTaskEnded::Status::Cancelled;
+			}
+			catch (const std::exception& error) {
+				ended.status   = OnTaskEnded::Status::Failed;
+				ended.errorMsg = error.what();
+			}
+			catch (...) {
+				ended.status   = OnTaskEnded::Status::Failed;
+				ended.errorMsg = "Unknown error";
+			}
+			promise.set_value();
+			EventEmitter<OnAsyncTaskEnded>().Emit(std::move(ended));
+		}(std::move(task), std::move(promise), type, futureTask);
+
+		return future;
+	}
+}
+
+#endif // !JADE_ASYNC_TASK_HEADER
\ No newline at end of file
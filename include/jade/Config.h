@@ -4,15 +4,36 @@
 namespace jade {
 	class Config {
 	public:
-		static constexpr enum class Backend {
-			CONSOLE
-		} BackendType = Backend::CONSOLE;
+		enum class Backend {
+			CONSOLE,
+			SOCKET,
+			BATCH
+		};
+
+		// Selected with the JADE_BACKEND CMake option
+	#if defined(JADE_BACKEND_SOCKET)
+		static constexpr Backend BackendType = Backend::SOCKET;
+	#elif defined(JADE_BACKEND_BATCH)
+		static constexpr Backend BackendType = Backend::BATCH;
+	#else
+		static constexpr Backend BackendType = Backend::CONSOLE;
+	#endif
+
+	#ifdef JADE_NULL_AUDIO_DEVICE
+		static constexpr bool UseNullAudioDevice = true;
+	#else
+		static constexpr bool UseNullAudioDevice = false;
+	#endif
 
 		class Paths {
 		public:
 			static constexpr const char* MusicMetadataFile = "./mdb.bin";
 			static constexpr const char* MusicPlaylistFile = "./mpl.bin";
 			static constexpr const char* MusicStorage	   = "./music";
+			static constexpr const char* TraceFile		   = "./trace.json";
+			static constexpr const char* HistoryFile	   = "./history.txt";
+			static constexpr const char* ControlSocket	   = "./jade.sock";
+			static constexpr const char* BatchScript	   = ""; // stdin when empty
 		};
 	};
 }
@@ -1,21 +1,44 @@
 #ifndef JADE_CORE_HEADER
 #define JADE_CORE_HEADER
 
+#include <array>
+#include <deque>
+#include <mutex>
 #include <atomic>
 #include <future>
 #include <memory>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include <cmath>
+#include <cfloat>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
 
 namespace _jade {
 	class FutureTaskTypeErased {
 	public:
 		virtual ~FutureTaskTypeErased() = default;
+		virtual bool IsReady() const = 0;
 	};
 
 	template <typename T>
 	class FutureTaskTypeErasedImpl : public FutureTaskTypeErased {
 	public:
 		FutureTaskTypeErasedImpl(std::future<T>&& future) : future(std::move(future)) {}
-		virtual ~FutureTaskTypeErasedImpl() = default;
+
+		// Thread pool futures do not block on destruction like std::async ones do
+		virtual ~FutureTaskTypeErasedImpl() {
+			if (future.valid()) {
+				future.wait();
+			}
+		}
+
+		virtual bool IsReady() const override {
+			return !future.valid() || future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
 
 	public:
 		std::future<T> future;
@@ -23,9 +46,135 @@ namespace _jade {
 }
 
 namespace jade {
+	template <typename... Types>
+	struct TypeList {
+		static constexpr size_t Size = sizeof...(Types);
+
+		template <typename T>
+		static constexpr bool Contains = (std::is_same_v<T, Types> || ...);
+
+		// Returns Size when T is not part of the list
+		template <typename T>
+		static consteval size_t IndexOf() {
+			size_t index = 0;
+			bool found = ((std::is_same_v<T, Types> ? true : (++index, false)) || ...);
+			return found ? index : Size;
+		}
+	};
+
+	// Qualified type name taken from the compiler's function signature string
+	template <typename T>
+	constexpr std::string_view TypeName() noexcept {
+	#if defined(_MSC_VER)
+		std::string_view signature = __FUNCSIG__;
+		size_t begin = signature.find("TypeName<") + sizeof("TypeName<") - 1;
+		size_t end   = signature.rfind(">(void)");
+	#else
+		std::string_view signature = __PRETTY_FUNCTION__;
+		size_t begin = signature.find("T = ") + sizeof("T = ") - 1;
+		size_t end   = signature.find_first_of(";]", begin);
+	#endif
+		std::string_view name = signature.substr(begin, end - begin);
+		for (std::string_view prefix : { std::string_view("struct "), std::string_view("class ") }) {
+			if (name.starts_with(prefix)) {
+				name.remove_prefix(prefix.size());
+			}
+		}
+		return name;
+	}
+
+	template <typename Signature, size_t BufferSize = 4 * sizeof(void*)>
+	class Delegate;
+
+	// Move-only type-erased callable stored entirely inside the object.
+	// Callables that do not fit the buffer are rejected at compile time.
+	template <typename R, typename... Args, size_t BufferSize>
+	class Delegate<R(Args...), BufferSize> {
+	public:
+		Delegate() = default;
+
+		template <typename Function>
+		requires(!std::is_same_v<std::decay_t<Function>, Delegate> && std::is_invocable_r_v<R, std::decay_t<Function>&, Args...>)
+		Delegate(Function&& function) {
+			using Functor = std::decay_t<Function>;
+
+			static_assert(sizeof(Functor) <= BufferSize,
+				"jade::Delegate - callable exceeds small buffer size");
+			static_assert(alignof(Functor) <= alignof(std::max_align_t),
+				"jade::Delegate - callable is over-aligned");
+
+			new (m_buffer) Functor(std::forward<Function>(function));
+			m_invoke = [](void* buffer, Args... args) -> R {
+				return (*(Functor*)buffer)(std::forward<Args>(args)...);
+			};
+			if constexpr (!std::is_trivially_copyable_v<Functor> || !std::is_trivially_destructible_v<Functor>) {
+				m_manage = [](_Operation operation, void* destination, void* source) {
+					if (operation == _Operation::Move) {
+						new (destination) Functor(std::move(*(Functor*)source));
+					}
+					((Functor*)source)->~Functor();
+				};
+			}
+		}
+
+		Delegate(Delegate&& other) noexcept { _MoveFrom(other); }
+
+		Delegate& operator=(Delegate&& other) noexcept {
+			if (this != &other) {
+				_Reset();
+				_MoveFrom(other);
+			}
+			return *this;
+		}
+
+		Delegate(const Delegate&) = delete;
+		Delegate& operator=(const Delegate&) = delete;
+
+		~Delegate() { _Reset(); }
+
+	public:
+		inline R operator()(Args... args) const {
+			return m_invoke((void*)m_buffer, std::forward<Args>(args)...);
+		}
+
+		inline explicit operator bool() const noexcept { return m_invoke != nullptr; }
+
+	private:
+		enum class _Operation : uint8_t { Move, Destroy };
+
+		void _MoveFrom(Delegate& other) noexcept {
+			if (other.m_manage != nullptr) {
+				other.m_manage(_Operation::Move, m_buffer, other.m_buffer);
+			}
+			else if (other.m_invoke != nullptr) {
+				std::memcpy(m_buffer, other.m_buffer, BufferSize);
+			}
+			m_invoke = other.m_invoke;
+			m_manage = other.m_manage;
+
+			other.m_invoke = nullptr;
+			other.m_manage = nullptr;
+		}
+
+		void _Reset() noexcept {
+			if (m_manage != nullptr) {
+				m_manage(_Operation::Destroy, nullptr, m_buffer);
+			}
+			m_invoke = nullptr;
+			m_manage = nullptr;
+		}
+
+	private:
+		alignas(std::max_align_t) std::byte m_buffer[BufferSize];
+
+		R(*m_invoke)(void*, Args...) = nullptr;
+		void(*m_manage)(_Operation, void*, void*) = nullptr;
+	};
+
 	enum class TaskType {
 		// Cancellable
 		AsyncMusicLibraryAdd,
+		AsyncMusicLibraryImport,
 
 		AsyncCancellableCount,
 
@@ -54,14 +203,14 @@ namespace jade {
 		Timestep() = default;
 		Timestep(double timestep) : m_timestep(timestep) {}
 
-		inline bool operator==(const Timestep& other) noexcept {
+		inline bool operator==(const Timestep& other) const noexcept {
 			return std::fabs(m_timestep - other.m_timestep) < DBL_EPSILON;
 		}
 
-		inline bool operator<(const Timestep& other) noexcept { return m_timestep < other.m_timestep; }
-		inline bool operator<=(const Timestep& other) noexcept { return m_timestep <= other.m_timestep; }
-		inline bool operator>(const Timestep& other) noexcept { return m_timestep > other.m_timestep; }
-		inline bool operator>=(const Timestep& other) noexcept { return m_timestep >= other.m_timestep; }
+		inline bool operator<(const Timestep& other) const noexcept { return m_timestep < other.m_timestep; }
+		inline bool operator<=(const Timestep& other) const noexcept { return m_timestep <= other.m_timestep; }
+		inline bool operator>(const Timestep& other) const noexcept { return m_timestep > other.m_timestep; }
+		inline bool operator>=(const Timestep& other) const noexcept { return m_timestep >= other.m_timestep; }
 
 		inline Timestep& operator+=(const Timestep& other) noexcept {
 			m_timestep += other.m_timestep;
@@ -80,16 +229,50 @@ namespace jade {
 		double m_timestep = 0.0;
 	};
 
+	// Shared cancellation flag. A child token reports cancellation when any of its
+	// ancestors is cancelled, cancelling a child does not affect the parent.
+	class CancellationToken {
+	public:
+		CancellationToken() : m_state(std::make_shared<_State>()) {}
+
+	public:
+		inline CancellationToken CreateChild() const {
+			CancellationToken child;
+			child.m_state->parent = m_state;
+			return child;
+		}
+
+		inline void Cancel() const noexcept { m_state->cancelled.store(true, std::memory_order_relaxed); }
+
+		inline bool IsCancelled() const noexcept {
+			for (const _State* state = m_state.get(); state != nullptr; state = state->parent.get()) {
+				if (state->cancelled.load(std::memory_order_relaxed)) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+	private:
+		struct _State {
+			std::atomic<bool>       cancelled = false;
+			std::shared_ptr<_State> parent;
+		};
+
+	private:
+		std::shared_ptr<_State> m_state;
+	};
+
 	class AsyncCancellationController {
 	public:
 		AsyncCancellationController() = default;
 
-		inline void Cancel() { m_shouldCancel.store(true, std::memory_order_relaxed); }
-		inline void Reset() { m_shouldCancel.store(false, std::memory_order_relaxed); }
-		inline bool ShouldCancel() { return m_shouldCancel.load(std::memory_order_relaxed); }
+		inline void Cancel() { m_token.Cancel(); }
+		inline bool ShouldCancel() { return m_token.IsCancelled(); }
+		inline const CancellationToken& GetToken() const noexcept { return m_token; }
 
 	private:
-		std::atomic<bool> m_shouldCancel{ false };
+		CancellationToken m_token;
 	};
 
 	struct FutureTask {
@@ -100,6 +283,11 @@ namespace jade {
 		inline void Wait() noexcept { m_future.reset(); }
 		inline void Cancel() noexcept { m_controller.Cancel(); }
 		inline bool ShouldCancel() noexcept { return m_controller.ShouldCancel(); }
+		inline bool IsReady() const { return !m_future || m_future->IsReady(); }
+		inline const CancellationToken& GetCancellationToken() const noexcept { return m_controller.GetToken(); }
+
+		inline void SetProgress(float progress) noexcept { m_progress.store(progress, std::memory_order_relaxed); }
+		inline float GetProgress() const noexcept { return m_progress.load(std::memory_order_relaxed); }
 
 		template <typename T>
 		void SetTask(std::future<T>&& future) {
@@ -110,6 +298,94 @@ namespace jade {
 	private:
 		AsyncCancellationController                  m_controller;
 		std::unique_ptr<_jade::FutureTaskTypeErased> m_future;
+		std::atomic<float>                           m_progress = 0.0f;
+	};
+
+	enum class TaskPriority : uint8_t {
+		High,
+		Normal,
+		Low,
+
+		Count
+	};
+
+	// Fixed set of workers, each owning one deque per priority. Workers pop their own
+	// deques from the back and steal from the front of the others; submissions from
+	// outside the pool are spread round-robin. Higher priorities are always drained
+	// first, across all workers.
+	class ThreadPool {
+	public:
+		using Job = Delegate<void()>;
+
+		static constexpr size_t s_PriorityCount = (size_t)TaskPriority::Count;
+
+	public:
+		explicit ThreadPool(size_t workerCount = DefaultWorkerCount());
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		static ThreadPool& Get() noexcept;
+		static size_t DefaultWorkerCount() noexcept;
+
+	public:
+		template <typename Function>
+		auto Submit(Function&& function, TaskPriority priority = TaskPriority::Normal)
+		-> std::future<std::invoke_result_t<std::decay_t<Function>&>> {
+			using Result = std::invoke_result_t<std::decay_t<Function>&>;
+
+			std::packaged_task<Result()> task(std::forward<Function>(function));
+			std::future<Result> future = task.get_future();
+
+			_Push(Job([task = std::move(task)]() mutable { task(); }), priority);
+			return future;
+		}
+
+		inline void Post(Job&& job, TaskPriority priority = TaskPriority::Normal) {
+			_Push(std::move(job), priority);
+		}
+
+		// Waits for the future, running queued jobs in the meantime so that jobs
+		// waiting on jobs they submitted cannot starve the pool
+		template <typename T>
+		T Await(std::future<T>& future) {
+			while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				if (!RunPendingJob()) {
+					future.wait_for(s_AwaitPollInterval);
+				}
+			}
+			return future.get();
+		}
+
+		bool RunPendingJob();
+
+		inline size_t GetWorkerCount() const noexcept { return m_workers.size(); }
+		bool IsWorkerThread() const noexcept;
+
+	private:
+		static constexpr std::chrono::microseconds s_AwaitPollInterval{ 200 };
+
+		struct _Worker {
+			std::mutex                                   mutex;
+			std::array<std::deque<Job>, s_PriorityCount> jobs;
+			std::thread                                  thread;
+		};
+
+		void _Push(Job&& job, TaskPriority priority);
+		bool _TryPop(size_t workerIndex, Job& job);
+		bool _TryPopPass(size_t workerIndex, Job& job, bool isBlocking, bool& isContended);
+		void _WorkerLoop(size_t workerIndex);
+
+	private:
+		std::vector<std::unique_ptr<_Worker>> m_workers;
+
+		std::atomic<size_t> m_pendingCount = 0;
+		std::atomic<size_t> m_nextWorker   = 0;
+		std::atomic<bool>   m_stopping     = false;
+
+		std::mutex              m_sleepMutex;
+		std::condition_variable m_sleepCondition;
 	};
 }
 
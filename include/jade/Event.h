@@ -5,8 +5,31 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
+#include <coroutine>
 
 namespace jade {
+	enum class EventOverflowPolicy : uint8_t {
+		Grow,	  // spill into growable storage
+		Block,	  // producer waits until the consumer frees space
+		Coalesce  // replace the last pending event when it has the same type
+	};
+
+	// How a new event is folded into an identical-typed event queued right before it
+	enum class EventCoalescing : uint8_t {
+		None,
+		KeepLast, // the newer payload replaces the pending one
+		Merge,	  // EventTraits<T>::Merge(T& pending, const T& incoming) -> bool
+		Count	  // equal payloads (operator==) add up their 'repeat' field
+	};
+
+	// Per event type dispatch properties, specialize to override
+	template <typename EventData>
+	struct EventTraits {
+		static constexpr EventOverflowPolicy overflow   = EventOverflowPolicy::Grow;
+		static constexpr EventCoalescing     coalescing = EventCoalescing::None;
+	};
+
 	enum class KeyModifier : uint32_t {
 		None = 0x0,
 
@@ -72,8 +95,76 @@ namespace jade {
 		bool	    pressed;
 		Key			key;
 		KeyModifier mods;
+		uint32_t    repeat = 1;
+
+	public:
+		inline bool operator==(const OnKeyAction& other) const noexcept {
+			return pressed == other.pressed && key == other.key && mods == other.mods;
+		}
+	};
+
+	// Only keys whose handlers honour 'repeat' are folded: printable keys typed without
+	// Ctrl/Alt, Backspace and the arrows. Enter, Tab and shortcuts arrive one by one.
+	template <>
+	struct EventTraits<OnKeyAction> {
+		static constexpr EventOverflowPolicy overflow   = EventOverflowPolicy::Grow;
+		static constexpr EventCoalescing     coalescing = EventCoalescing::Merge;
+
+		static bool Merge(OnKeyAction& pending, const OnKeyAction& incoming) noexcept {
+			if (!(pending == incoming) || !IsRepeatable(incoming)) {
+				return false;
+			}
+			pending.repeat += incoming.repeat;
+			return true;
+		}
+
+		static bool IsRepeatable(const OnKeyAction& keyAction) noexcept {
+			KeyModifier shortcutMods = KeyModifier::LCtrl | KeyModifier::RCtrl | KeyModifier::Ctrl |
+				KeyModifier::LAlt | KeyModifier::RAlt | KeyModifier::Alt;
+
+			switch (keyAction.key) {
+				case Key::Backspace:
+				case Key::Left:
+				case Key::Right:
+				case Key::Up:
+				case Key::Down:
+					return true;
+
+				default:
+					break;
+			}
+			bool isPrintable = (keyAction.key >= Key::A && keyAction.key <= Key::N9) ||
+				keyAction.key == Key::Space || (keyAction.key >= Key::Minus && keyAction.key <= Key::Dot);
+			return isPrintable && (keyAction.mods & shortcutMods) == KeyModifier::None;
+		}
 	};
 	
+	// Emitted by the audio callback once the first frame of a track is played
+	struct OnTrackStarted {
+		uint64_t trackID = UINT64_MAX;
+	};
+
+	// Emitted by the audio callback once the play queue has run out
+	struct OnPlaybackFinished {};
+
+	// Posted by ResumeOnMainThread, resumed by EventSystem itself. The event owns the
+	// handle, one that is never dispatched is destroyed along with it.
+	struct OnCoroutineResume {
+		explicit OnCoroutineResume(std::coroutine_handle<> handle) noexcept : handle(handle) {}
+		OnCoroutineResume(OnCoroutineResume&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+		OnCoroutineResume(const OnCoroutineResume&) = delete;
+		OnCoroutineResume& operator=(const OnCoroutineResume&) = delete;
+
+		~OnCoroutineResume() {
+			if (handle) {
+				handle.destroy();
+			}
+		}
+
+		std::coroutine_handle<> handle;
+	};
+
 	struct OnApplicationClose {
 		enum : uint8_t {
 			ShouldClose,
@@ -83,6 +174,18 @@ namespace jade {
 
 		uint8_t closeState = ShouldClose;
 	};
+
+	// Every event type handled by jade::EventSystem has to be listed here.
+	// The position in the list is the event ID.
+	using RegisteredEvents = TypeList<
+		OnTaskEnded,
+		OnAsyncTaskEnded,
+		OnKeyAction,
+		OnTrackStarted,
+		OnPlaybackFinished,
+		OnCoroutineResume,
+		OnApplicationClose
+	>;
 }
 
 #endif // !JADE_EVENT_HEADER
\ No newline at end of file
@@ -1,92 +1,238 @@
 #ifndef JADE_EVENT_SYSTEM_HEADER
 #define JADE_EVENT_SYSTEM_HEADER
 
-#include <functional>
+#include <jade/Event.h>
+#include <jade/TimerWheel.h>
+#include <jade/Platform.h>
+
+#include <algorithm>
+#include <mutex>
 #include <vector>
 #include <array>
+#include <span>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <cstddef>
+#include <type_traits>
+
+namespace _jade {
+	template <typename EventData>
+	void DestroyEventPayload(void* data) {
+		((EventData*)data)->~EventData();
+	}
+
+	template <typename... Events>
+	consteval std::array<void(*)(void*), sizeof...(Events)> MakeEventPayloadDestructors(jade::TypeList<Events...>) {
+		return { (std::is_trivially_destructible_v<Events> ? nullptr : &DestroyEventPayload<Events>)... };
+	}
+
+	template <typename... Events>
+	consteval std::array<uint32_t, sizeof...(Events)> MakeEventPayloadSizes(jade::TypeList<Events...>) {
+		return { (std::is_empty_v<Events> ? 0u : (uint32_t)sizeof(Events))... };
+	}
+
+	template <typename... Events>
+	consteval std::array<std::string_view, sizeof...(Events)> MakeEventNames(jade::TypeList<Events...>) {
+		return { jade::TypeName<Events>()... };
+	}
+}
 
 namespace jade {
-	class EventSystem;
-
 	template <typename EventData>
-	class EventEmitter {
-	public:
-		static_assert(sizeof(EventData) <= EventSystem::s_MaxEventDataBytes,
-			"jade::EventSystem - exceeded max event data struct size in bytes");
+	class EventEmitter;
 
+	class EventSystem {
 	public:
-		EventEmitter() = default;
+		static constexpr uint16_t s_QueueSize           = 1024;
+		static constexpr uint16_t s_ConcurrentQueueSize = 1024;
+		static constexpr uint16_t s_MaxEventDataBytes   = 256;
+		static constexpr uint32_t s_StorageChunkBytes   = 64 * 1024;
 
 	public:
-		void Emit(const EventData& data) { EventSystem::Get().Register(data); }
-		void Emit(EventData&& data) { EventSystem::Get().Register(std::move(data)); }
-
-		void Emit() requires(std::is_empty_v<EventData>) {
-			EventSystem::Get().template Register<EventData>();
-		}
-
-		void EmitInstant(const EventData& data) { EventSystem::Get().RegisterInstant(data); }
+		static constexpr uint32_t s_EventCount = (uint32_t)RegisteredEvents::Size;
 
-		void EmitInstant() requires(std::is_empty_v<EventData>) {
-			EventSystem::Get().template RegisterInstant<EventData>();
-		}
-	};
-
-	class EventSystem {
-	public:
 		template <typename EventData>
 		struct EventID {
-			inline static uint32_t id = UINT32_MAX;
-		};
+			static_assert(RegisteredEvents::Contains<EventData>,
+				"jade::EventSystem - event type is not listed in jade::RegisteredEvents");
+			static_assert(sizeof(EventData) <= s_MaxEventDataBytes,
+				"jade::EventSystem - exceeded max event data struct size in bytes");
 
-		template <>
-		struct EventID<void> {
-			inline static uint32_t ids = 0;
+			static constexpr uint32_t id = (uint32_t)RegisteredEvents::IndexOf<EventData>();
 		};
 
+		// Chunked bump allocator for event payloads. Chunks are never moved or
+		// released on Reset(), so pointers stay valid until the end of a frame and
+		// the storage only grows to the peak number of bytes used in one frame.
 		class MemoryStorage {
 		public:
 			MemoryStorage() = default;
-			MemoryStorage(size_t bytes);
+			MemoryStorage(size_t chunkBytes);
 
 			~MemoryStorage();
 
+			MemoryStorage(const MemoryStorage&) = delete;
+			MemoryStorage& operator=(const MemoryStorage&) = delete;
+
 		public:
-			void Allocate(size_t bytes);
+			void Allocate(size_t chunkBytes);
 			void Deallocate();
 
-			template <typename T>
-			void Push(T&& value) {
-				if (m_storageTail - m_storageHead + sizeof(T) >= m_allocated) {
-					return;
-				}
-				T* where = (T*)(m_storage + m_storageTail);
-				new (where) T(std::forward<T>(value));
-				m_storageTail += sizeof(T);
+			template <typename T, typename U>
+			T* Push(U&& value) {
+				void* where = _Reserve(sizeof(T), alignof(T));
+				return new (where) T(std::forward<U>(value));
 			}
 
-			template <typename T>
-			void Pop() {
-				if constexpr (!std::is_trivially_destructible_v<T>) {
-					if (m_storageHead + sizeof(T) <= m_storageTail) {
-						((T*)(m_storage + m_storageHead))->~T();
+			inline void Reset() noexcept { m_chunkIndex = m_chunkOffset = 0; }
+			inline size_t GetAllocatedBytes() const noexcept { return m_chunks.size() * m_chunkBytes; }
+
+		private:
+			void* _Reserve(size_t bytes, size_t alignment);
+
+		private:
+			size_t                  m_chunkBytes  = 0;
+			size_t                  m_chunkIndex  = 0;
+			size_t                  m_chunkOffset = 0;
+			std::vector<std::byte*> m_chunks;
+		};
+
+		struct Metrics {
+			uint64_t registered     = 0;
+			uint64_t dispatched     = 0;
+			uint64_t spilled        = 0;
+			uint64_t blocked        = 0;
+			uint64_t coalesced      = 0;
+			uint64_t dropped        = 0;
+			size_t   peakQueueDepth = 0;
+			size_t   storageBytes   = 0;
+		};
+
+		// Bounded multi-producer/single-consumer ring (sequence-numbered cells).
+		// Worker threads push into it, the main thread relays its contents into the
+		// regular event queue at the beginning of Dispatch().
+		class ConcurrentQueue {
+		public:
+			using RelayFunction = void(*)(EventSystem*, void*);
+
+			ConcurrentQueue(size_t capacity);
+			~ConcurrentQueue();
+
+			ConcurrentQueue(const ConcurrentQueue&) = delete;
+			ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+		public:
+			template <typename T, typename U>
+			bool TryPush(U&& value) {
+				_Cell* cell = nullptr;
+				size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+
+				for (;;) {
+					cell = &m_cells[position & m_mask];
+					size_t sequence = cell->sequence.load(std::memory_order_acquire);
+					intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+					if (difference == 0) {
+						if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+							break;
+						}
+					}
+					else if (difference < 0) {
+						return false;
+					}
+					else {
+						position = m_enqueuePosition.load(std::memory_order_relaxed);
 					}
 				}
-				m_storageHead += sizeof(T);
+				new (cell->data) T(std::forward<U>(value));
+				cell->relay = &EventSystem::_Relay<T>;
+				cell->sequence.store(position + 1, std::memory_order_release);
+				return true;
 			}
 
-			template <typename T>
-			T* Get() {
-				return (T*)(m_storage + m_storageHead);
+			// Applies the overflow policy of the event type when the ring is full.
+			// Growing spills into a mutex-guarded storage; once a spill has started
+			// every producer keeps spilling until the consumer drains it, so events of
+			// one producer are never reordered. The policy can be overridden per call.
+			template <typename T, EventOverflowPolicy policy = EventTraits<T>::overflow, typename U>
+			void Push(U&& value) {
+				if constexpr (policy == EventOverflowPolicy::Block) {
+					if (TryPush<T>(std::forward<U>(value))) {
+						return;
+					}
+					m_blocked.fetch_add(1, std::memory_order_relaxed);
+					while (!TryPush<T>(std::forward<U>(value))) {
+						std::this_thread::yield();
+					}
+				}
+				else {
+					if (!m_spilling.load(std::memory_order_acquire) && TryPush<T>(std::forward<U>(value))) {
+						return;
+					}
+					_Spill<T>(std::forward<U>(value), policy == EventOverflowPolicy::Coalesce);
+				}
 			}
 
-			inline void Reset() { m_storageHead = m_storageTail = 0; }
+			size_t Drain(EventSystem& system);
+
+			inline uint64_t GetSpilledCount() const noexcept { return m_spilled.load(std::memory_order_relaxed); }
+			inline uint64_t GetBlockedCount() const noexcept { return m_blocked.load(std::memory_order_relaxed); }
+			inline uint64_t GetCoalescedCount() const noexcept { return m_coalesced.load(std::memory_order_relaxed); }
+			inline uint64_t GetDroppedCount() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
 
 		private:
-			size_t	   m_allocated	 = 0;
-			size_t     m_storageHead = 0;
-			size_t     m_storageTail = 0;
-			std::byte* m_storage     = nullptr;
+			template <typename T, typename U>
+			void _Spill(U&& value, bool coalesce) {
+				std::lock_guard<std::mutex> lock(m_spillMutex);
+				m_spilling.store(true, std::memory_order_release);
+
+				// Only the last spilled event is replaced, an older one of the same type may
+				// sit before events of other types that were emitted ahead of this one
+				if (coalesce && !m_spilledEvents.empty() && m_spilledEvents.back().relay == &EventSystem::_Relay<T>) {
+					_SpilledEvent& pending = m_spilledEvents.back();
+					pending.relay(nullptr, pending.data);
+					new (pending.data) T(std::forward<U>(value));
+					m_coalesced.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+				try {
+					T* data = m_spillData.Push<T>(std::forward<U>(value));
+					m_spilledEvents.emplace_back(_SpilledEvent{ .relay = &EventSystem::_Relay<T>, .data = data });
+					m_spilled.fetch_add(1, std::memory_order_relaxed);
+				}
+				catch (const std::bad_alloc&) {
+					m_dropped.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+
+		private:
+			struct _SpilledEvent {
+				RelayFunction relay = nullptr;
+				void*         data  = nullptr;
+			};
+
+			struct _Cell {
+				std::atomic<size_t> sequence{ 0 };
+				RelayFunction       relay = nullptr;
+				alignas(std::max_align_t) std::byte data[s_MaxEventDataBytes];
+			};
+
+			size_t                   m_mask = 0;
+			std::unique_ptr<_Cell[]> m_cells;
+
+			alignas(64) std::atomic<size_t> m_enqueuePosition{ 0 };
+			alignas(64) size_t              m_dequeuePosition = 0;
+
+			std::mutex                 m_spillMutex;
+			std::atomic<bool>          m_spilling{ false };
+			MemoryStorage              m_spillData{ s_StorageChunkBytes };
+			std::vector<_SpilledEvent> m_spilledEvents;
+
+			std::atomic<uint64_t> m_spilled{ 0 };
+			std::atomic<uint64_t> m_blocked{ 0 };
+			std::atomic<uint64_t> m_coalesced{ 0 };
+			std::atomic<uint64_t> m_dropped{ 0 };
 		};
 
 	public:
@@ -97,122 +243,254 @@ namespace jade {
 		~EventSystem();
 
 	public:
-		static constexpr uint16_t s_QueueSize		  = 1024;
-		static constexpr uint16_t s_MaxEventDataBytes = 256;
-
 		static EventSystem& Get() noexcept;
 		static const EventSystem& GetConst() noexcept;
 
 	public:
+		inline bool IsMainThread() const noexcept { return std::this_thread::get_id() == m_mainThreadId; }
+
 		template <typename EventData>
 		void Register(EventData&& data) {
-			_ValidateEvent<EventData>();
+			using Event = std::remove_cvref_t<EventData>;
 
-			if (m_eventQueueTail - m_eventQueueHead >= s_QueueSize) {
+			if (!IsMainThread()) {
+				_RegisterConcurrent<Event>(std::forward<EventData>(data));
 				return;
 			}
-			m_eventQueue[m_eventQueueTail++] = EventID<EventData>::id;
-			m_eventsData.Push<EventData>(std::forward<EventData>(data));
+			++m_metrics.registered;
+
+			if constexpr (EventTraits<Event>::coalescing != EventCoalescing::None) {
+				if (_TryCoalesce<Event>(data)) {
+					++m_metrics.coalesced;
+					return;
+				}
+			}
+			Event* payload = m_eventsData.Push<Event>(std::forward<EventData>(data));
+			m_eventQueue.emplace_back(_QueuedEvent{ .id = EventID<Event>::id, .data = payload });
 		}
 
 		template <typename EventData>
 		void Register() requires(std::is_empty_v<EventData>) {
-			_ValidateEvent<EventData>();
-
-			if (m_eventQueueTail - m_eventQueueHead >= s_QueueSize) {
+			if (!IsMainThread()) {
+				_RegisterConcurrent<EventData>(EventData{});
 				return;
 			}
-			m_eventQueue[m_eventQueueTail++] = EventID<EventData>::id;
+			m_eventQueue.emplace_back(_QueuedEvent{ .id = EventID<EventData>::id, .data = nullptr });
+			++m_metrics.registered;
 		}
 
 		template <typename EventData>
 		void RegisterInstant(const EventData& data) {
-			for (auto& subscriber : m_subscriberTable[EventID<EventData>::id]) {
-				subscriber(&data);
+			for (const _Subscriber& subscriber : m_subscriberTable[EventID<EventData>::id]) {
+				subscriber.function((void*)&data, 1);
 			}
 		}
 
 		template <typename EventData>
 		void RegisterInstant() requires(std::is_empty_v<EventData>) {
-			for (auto& subscriber : m_subscriberTable[EventID<EventData>::id]) {
-				subscriber(nullptr);
+			for (const _Subscriber& subscriber : m_subscriberTable[EventID<EventData>::id]) {
+				subscriber.function(nullptr, 1);
 			}
 		}
 
 		template <typename EventData, typename Function>
 		void Subscribe(uint64_t priority, Function function) {
-			_ValidateEvent<EventData>();
-
-			auto comparator = [](const _Subscriber& l, const _Subscriber& r) -> bool {
-				return l.priority > r.priority;
-			};
-			auto pos = std::lower_bound(
-				m_subscriberTable[EventID<EventData>::id].begin(),
-				m_subscriberTable[EventID<EventData>::id].end(),
-				_Subscriber{ .priority = priority, .function = {} },
-				comparator
-			);
-
-			_Subscriber subscriber = {};
-			subscriber.priority = priority;
-			subscriber.function = [function](void* data) {
+			_InsertSubscriber<EventData>(priority, [function](void* data, size_t count) mutable {
 				if constexpr (std::is_empty_v<EventData>) {
-					function();
+					for (size_t i = 0; i < count; ++i) {
+						function();
+					}
 				}
 				else {
-					EventData& ref = *(EventData*)data;
-					function(ref);
+					EventData* events = (EventData*)data;
+					for (size_t i = 0; i < count; ++i) {
+						function(events[i]);
+					}
 				}
-			};
-			m_subscriberTable[EventID<EventData>::id].insert(pos, std::move(subscriber));
+			});
+		}
+
+		// Receives every run of consecutive same-typed events stored contiguously
+		// in one call. Within such a run subscribers are invoked in priority order,
+		// each one seeing the whole run before the next subscriber.
+		template <typename EventData, typename Function>
+		void SubscribeBatch(uint64_t priority, Function function) requires(!std::is_empty_v<EventData>) {
+			_InsertSubscriber<EventData>(priority, [function](void* data, size_t count) mutable {
+				function(std::span<EventData>((EventData*)data, count));
+			});
+		}
+
+		// Timers are main-thread only; the payload is copied into the timer and
+		// registered as a regular event when it expires (every interval for periodic ones).
+		template <typename EventData>
+		TimerHandle RegisterAfter(Timestep delay, const EventData& data) {
+			return m_timerWheel.Schedule(_SecondsToTicks(delay), 0, _MakeTimerCallback(data));
+		}
+
+		template <typename EventData>
+		TimerHandle RegisterEvery(Timestep interval, const EventData& data) {
+			uint64_t intervalTicks = std::max<uint64_t>(_SecondsToTicks(interval), 1);
+			return m_timerWheel.Schedule(intervalTicks, intervalTicks, _MakeTimerCallback(data));
 		}
 
+		inline bool CancelTimer(TimerHandle handle) { return m_timerWheel.Cancel(handle); }
+
+		// Negative when no timer is scheduled
+		Timestep GetTimeUntilNextTimer() const noexcept;
+
+		void Update(Timestep deltaTime);
 		void Dispatch();
 
+		Metrics GetMetrics() const noexcept;
+
 	private:
+		template <typename EventData, typename Function>
+		void _InsertSubscriber(uint64_t priority, Function&& function) {
+			std::vector<_Subscriber>& subscribers = m_subscriberTable[EventID<EventData>::id];
+
+			auto pos = std::lower_bound(subscribers.begin(), subscribers.end(), priority,
+				[](const _Subscriber& subscriber, uint64_t priority) -> bool {
+					return subscriber.priority > priority;
+				}
+			);
+			subscribers.insert(pos, _Subscriber{ .priority = priority, .function = std::forward<Function>(function) });
+		}
+
+		// Folds the new event into the last queued one if both have the same type
+		// and that event has not been handed to subscribers yet.
 		template <typename EventData>
-		void _ValidateEvent() noexcept {
+		bool _TryCoalesce(const EventData& data) {
+			constexpr EventCoalescing coalescing = EventTraits<EventData>::coalescing;
+
+			if (m_eventQueue.size() <= m_dispatchedCount || m_eventQueue.back().id != EventID<EventData>::id) {
+				return false;
+			}
+			EventData& pending = *(EventData*)m_eventQueue.back().data;
+
+			if constexpr (coalescing == EventCoalescing::KeepLast) {
+				pending = data;
+				return true;
+			}
+			else if constexpr (coalescing == EventCoalescing::Merge) {
+				return EventTraits<EventData>::Merge(pending, data);
+			}
+			else if constexpr (coalescing == EventCoalescing::Count) {
+				if (!(pending == data)) {
+					return false;
+				}
+				pending.repeat += data.repeat;
+				return true;
+			}
+			return false;
+		}
+
+		static inline uint64_t _SecondsToTicks(Timestep time) noexcept {
+			return time.Seconds() <= 0.0 ? 0 : (uint64_t)std::ceil(time.Seconds() * 1000.0);
+		}
+
+		template <typename EventData>
+		TimerWheel::Callback _MakeTimerCallback(const EventData& data) {
+			if constexpr (std::is_empty_v<EventData>) {
+				return [this]() { Register<EventData>(); };
+			}
+			else {
+				return [this, data]() { Register(data); };
+			}
+		}
+
+		template <typename EventData, typename U>
+		void _RegisterConcurrent(U&& data) {
 			static_assert(sizeof(EventData) <= EventSystem::s_MaxEventDataBytes,
 				"jade::EventSystem - exceeded max event data struct size in bytes");
 
-			if (EventSystem::EventID<EventData>::id == UINT32_MAX) {
-				EventSystem::EventID<EventData>::id = EventSystem::EventID<void>::ids;
-				++EventSystem::EventID<void>::ids;
+			m_concurrentQueue.Push<EventData>(std::forward<U>(data));
 
-				if constexpr (!std::is_empty_v<EventData>) {
-					m_dispatchers.emplace_back([this]() {
-						EventData* data = m_eventsData.Get<EventData>();
-						for (auto& subscriber : m_subscriberTable[EventSystem::EventID<EventData>::id]) {
-							subscriber.function(data);
-						}
-						m_eventsData.Pop<EventData>();
-					});
+			if (!m_wakeupRequested.exchange(true, std::memory_order_acq_rel)) {
+				WakeMainThread();
+			}
+		}
+
+		// Runs on the main thread while draining the concurrent queue.
+		// A null system only destroys the payload (queue teardown).
+		template <typename EventData>
+		static void _Relay(EventSystem* system, void* data) {
+			EventData* event = (EventData*)data;
+			if (system != nullptr) {
+				if constexpr (std::is_empty_v<EventData>) {
+					system->Register<EventData>();
 				}
 				else {
-					m_dispatchers.emplace_back([this]() {
-						for (auto& subscriber : m_subscriberTable[EventSystem::EventID<EventData>::id]) {
-							subscriber.function(nullptr);
-						}
-					});
+					system->Register(std::move(*event));
 				}
 			}
+			event->~EventData();
 		}
 
 	private:
 		struct _Subscriber {
-			size_t					   priority = 0;
-			std::function<void(void*)> function;
+			uint64_t					  priority = 0;
+			Delegate<void(void*, size_t)> function;
 		};
 
-		using _SubscriberTable = std::vector<std::vector<_Subscriber>>;
-		using _Dispatchers     = std::vector<std::function<void()>>;
+		struct _QueuedEvent {
+			uint32_t id   = UINT32_MAX;
+			void*    data = nullptr;
+		};
+
+		using _SubscriberTable   = std::array<std::vector<_Subscriber>, s_EventCount>;
+		using _PayloadDestructor = void(*)(void*);
+
+	public:
+		static constexpr std::array<_PayloadDestructor, s_EventCount> s_PayloadDestructors =
+			_jade::MakeEventPayloadDestructors(RegisteredEvents{});
+		static constexpr std::array<uint32_t, s_EventCount> s_PayloadSizes =
+			_jade::MakeEventPayloadSizes(RegisteredEvents{});
+		static constexpr std::array<std::string_view, s_EventCount> s_EventNames =
+			_jade::MakeEventNames(RegisteredEvents{});
+
+	private:
+		std::vector<_QueuedEvent> m_eventQueue;
+		size_t                    m_dispatchedCount = 0;
+		MemoryStorage			  m_eventsData;
+		_SubscriberTable		  m_subscriberTable;
+		ConcurrentQueue           m_concurrentQueue{ s_ConcurrentQueueSize };
+		std::atomic<bool>         m_wakeupRequested{ false };
+		TimerWheel                m_timerWheel;
+		Timestep                  m_elapsedTime;
+		Metrics                   m_metrics;
+		std::thread::id           m_mainThreadId;
+	};
+
+	template <typename EventData>
+	class EventEmitter {
+	public:
+		static_assert(sizeof(EventData) <= EventSystem::s_MaxEventDataBytes,
+			"jade::EventSystem - exceeded max event data struct size in bytes");
+
+	public:
+		EventEmitter() = default;
+
+	public:
+		void Emit(const EventData& data) { EventSystem::Get().Register(data); }
+		void Emit(EventData&& data) { EventSystem::Get().Register(std::move(data)); }
+
+		void Emit() requires(std::is_empty_v<EventData>) {
+			EventSystem::Get().template Register<EventData>();
+		}
 
-		std::array<uint32_t, s_QueueSize> m_eventQueue;
-		MemoryStorage					  m_eventsData;
-		uint32_t						  m_eventQueueHead = 0;
-		uint32_t						  m_eventQueueTail = 0;
-		_Dispatchers                      m_dispatchers;
-		_SubscriberTable			      m_subscriberTable;
+		void EmitInstant(const EventData& data) { EventSystem::Get().RegisterInstant(data); }
+
+		TimerHandle EmitAfter(Timestep delay, const EventData& data = {}) {
+			return EventSystem::Get().RegisterAfter(delay, data);
+		}
+
+		TimerHandle EmitEvery(Timestep interval, const EventData& data = {}) {
+			return EventSystem::Get().RegisterEvery(interval, data);
+		}
+
+		void EmitInstant() requires(std::is_empty_v<EventData>) {
+			EventSystem::Get().template RegisterInstant<EventData>();
+		}
 	};
 }
 
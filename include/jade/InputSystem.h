@@ -4,22 +4,31 @@
 #include <jade/Core.h>
 #include <jade/Event.h>
 
+#include <array>
 #include <vector>
 #include <chrono>
+#include <cstdint>
 
 namespace jade {
 	class InputSystem {
 	public:
-		struct KeyState {
-			bool		pressed = false;
-			KeyModifier mods    = KeyModifier::None;
-			Timestep    delay   = 0.0;
+		static constexpr size_t s_NativeKeyCount = 256;
+
+		// One bit per native key code
+		using KeyBits = std::array<uint64_t, s_NativeKeyCount / 64>;
+
+		// Repeat timer of a key that is currently held
+		struct HeldKey {
+			int		    code  = 0;
+			KeyModifier mods  = KeyModifier::None;
+			Timestep    delay = 0.0;
 		};
 
 		struct UpdateContext {
 		public:
-			Timestep		       deltaTime;
-			std::vector<KeyState>& keyPressedState;
+			Timestep		      deltaTime;
+			KeyBits&              pressedKeys;
+			std::vector<HeldKey>& heldKeys;
 		};
 
 	public:
@@ -30,8 +39,15 @@ namespace jade {
 		static const InputSystem& GetConst() noexcept;
 
 	public:
+		// Switches the terminal into raw mode, until then nothing is read
+		void Enable();
+		inline bool IsEnabled() const noexcept { return m_isEnabled; }
+
 		void Update(Timestep deltaTime);
 
+		// Time until the next synthesized key repeat, negative when no key is held
+		Timestep GetTimeUntilNextRepeat() const noexcept;
+
 		char KeyToChar(Key, KeyModifier) const noexcept;
 
 		void GenerateKeyPressed(
@@ -41,7 +57,9 @@ namespace jade {
 		) const noexcept;
 
 	private:
-		std::vector<KeyState> m_keyPressedState;
+		KeyBits              m_pressedKeys = {};
+		std::vector<HeldKey> m_heldKeys;
+		bool                 m_isEnabled = false;
 	};
 }
 
@@ -3,8 +3,11 @@
 
 #include <jade/Event.h>
 #include <jade/Cache.h>
+#include <jade/AsyncTask.h>
+#include <jade/RadixTree.h>
 
 #include <map>
+#include <mutex>
 #include <vector>
 #include <future>
 #include <memory>
@@ -31,6 +34,11 @@ namespace jade {
 			std::vector<uint64_t> tracks;
 		};
 
+		enum class NameIndex : uint8_t {
+			Tracks,
+			Artists
+		};
+
 		enum ChangeState : uint64_t {
 			TrackListChangeBit = 0x1,
 			PlaylistChangeBit  = 0x2
@@ -45,7 +53,7 @@ namespace jade {
 		static const MusicLibrary& GetConst();
 
 	public:
-		std::future<void> SaveChanges();
+		std::future<void> SaveChanges(const std::shared_ptr<FutureTask>& task = nullptr);
 		TrackIterator GetTrackByID(uint64_t id) const;
 
 		std::future<void> Add(
@@ -56,6 +64,12 @@ namespace jade {
 			const std::shared_ptr<FutureTask>& task
 		);
 
+		// Adds every audio file found under the directory, named after the file
+		std::future<void> Import(
+			const std::filesystem::path& directory,
+			const std::shared_ptr<FutureTask>& task
+		);
+
 		std::string CreatePlaylist(
 			const std::string& name,
 			const std::vector<uint64_t>& ids
@@ -64,7 +78,26 @@ namespace jade {
 		TrackIterator TrackIteratorBegin() const;
 		TrackIterator TrackIteratorEnd() const;
 
+		// Track names map to the ID of the first track with that name
+		RadixTree::Completion CompleteName(NameIndex index, std::string_view prefix, size_t maxCandidates) const;
+
+	private:
+		AsyncTask<void> _SaveChangesAsync();
+		AsyncTask<void> _AddAsync(
+			std::vector<std::string> artists,
+			std::vector<std::string> feat,
+			std::string name,
+			std::filesystem::path path
+		);
+
+		void _WriteChanges();
+		void _IndexTrack(const TrackElement& track);
+
 	private:
+		std::mutex                       m_writeMutex;
+		mutable std::mutex               m_indexMutex;
+		RadixTree                        m_trackNames;
+		RadixTree                        m_artistNames;
 		uint64_t				         m_changeStates = 0;
 		std::map<uint64_t, TrackElement> m_tracks;
 		std::vector<PlaylistElement>     m_playlists;
@@ -86,12 +119,16 @@ namespace jade {
 		inline void SetMusicLibrary(MusicLibrary* library) noexcept { m_library = library; }
 
 	public:
-		std::future<void> SaveChanges();
+		std::future<void> SaveChanges(const std::shared_ptr<FutureTask>& task = nullptr);
 
 		MusicLibrary::TrackIterator GetTrackByID(uint64_t id) const;
 		inline MusicLibrary::TrackIterator TrackIteratorBegin() const { return m_library->TrackIteratorBegin(); }
 		inline MusicLibrary::TrackIterator TrackIteratorEnd() const { return m_library->TrackIteratorEnd(); }
 
+		inline RadixTree::Completion CompleteName(MusicLibrary::NameIndex index, std::string_view prefix, size_t maxCandidates) const {
+			return m_library->CompleteName(index, prefix, maxCandidates);
+		}
+
 		std::future<void> Add(
 			const std::vector<std::string>& artists,
 			const std::vector<std::string>& feat,
@@ -100,6 +137,11 @@ namespace jade {
 			const std::shared_ptr<FutureTask>& task
 		);
 
+		std::future<void> Import(
+			const std::filesystem::path& directory,
+			const std::shared_ptr<FutureTask>& task
+		);
+
 		std::string CreatePlaylist(
 			const std::string& name,
 			const std::vector<uint64_t>& ids
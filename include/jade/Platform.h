@@ -1,11 +1,29 @@
 #ifndef JADE_PLATFORM_HEADER
 #define JADE_PLATFORM_HEADER
 
+#include <jade/Core.h>
+
 #include <string>
 
 namespace jade {
 	bool IsConsoleWindowFocused();
 	std::string GetClipboardTextContent();
+
+	// Wakes WaitForMainThreadWakeup, safe to call from any thread
+	void WakeMainThread();
+
+	// Blocks until console input is available, WakeMainThread is called or the timeout
+	// expires. A negative timeout waits indefinitely.
+	void WaitForMainThreadWakeup(Timestep timeout);
+
+	// Called once console input reached end of file, WaitForMainThreadWakeup stops
+	// waiting on it
+	void SetConsoleInputClosed();
+
+#if !defined(_WIN32) && !defined(WIN32)
+	// Readiness of the descriptor also ends WaitForMainThreadWakeup, -1 removes it
+	void SetMainThreadWakeupFd(int fd);
+#endif
 }
 
 #endif // !JADE_PLATFORM_HEADER
\ No newline at end of file
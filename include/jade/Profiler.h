@@ -0,0 +1,112 @@
+#ifndef JADE_PROFILER_HEADER
+#define JADE_PROFILER_HEADER
+
+#include <jade/Core.h>
+#include <jade/Event.h>
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace jade {
+	enum class ProfileStage : uint32_t {
+		Frame,
+		Render,
+		Input,
+		Backend,
+		Timers,
+		Dispatch,
+		Wait,
+
+		Count
+	};
+
+	// Main thread only. Keeps the last s_SampleCount durations of every MainLoop
+	// stage and of every dispatched event type.
+	class Profiler {
+	public:
+		static constexpr size_t s_SampleCount = 1024;
+		static constexpr size_t s_StageCount  = (size_t)ProfileStage::Count;
+		static constexpr size_t s_SlotCount   = s_StageCount + RegisteredEvents::Size;
+
+		struct Summary {
+			uint64_t samples = 0;
+			uint64_t total   = 0;
+			double   p50     = 0.0;
+			double   p99     = 0.0;
+			double   max     = 0.0;
+		};
+
+	public:
+		Profiler();
+
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+
+		static Profiler& Get() noexcept;
+		static const Profiler& GetConst() noexcept;
+
+		static constexpr bool IsEnabled() noexcept {
+		#ifdef JADE_ENABLE_PROFILER
+			return true;
+		#else
+			return false;
+		#endif
+		}
+
+		static constexpr size_t StageSlot(ProfileStage stage) noexcept { return (size_t)stage; }
+		static constexpr size_t EventSlot(size_t eventID) noexcept { return s_StageCount + eventID; }
+
+	public:
+		void Record(size_t slot, uint64_t nanoseconds) noexcept;
+
+		// Percentiles are in microseconds
+		Summary Summarize(size_t slot) const;
+		std::string Report() const;
+
+	private:
+		struct _Histogram {
+			std::array<uint64_t, s_SampleCount> samples = {};
+			size_t   head  = 0;
+			uint64_t total = 0;
+		};
+
+	private:
+		std::vector<_Histogram> m_histograms;
+	};
+
+	class ProfileScope {
+	public:
+		explicit ProfileScope(size_t slot) noexcept :
+			m_slot(slot), m_start(std::chrono::steady_clock::now()) {}
+
+		~ProfileScope() {
+			auto elapsed = std::chrono::steady_clock::now() - m_start;
+			Profiler::Get().Record(m_slot, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		size_t m_slot;
+		std::chrono::steady_clock::time_point m_start;
+	};
+}
+
+#define JADE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define JADE_PROFILE_CONCAT(a, b) JADE_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef JADE_ENABLE_PROFILER
+	#define JADE_PROFILE_STAGE(stage) \
+		::jade::ProfileScope JADE_PROFILE_CONCAT(_jadeProfileScope, __LINE__)(::jade::Profiler::StageSlot(stage))
+	#define JADE_PROFILE_EVENT(eventID) \
+		::jade::ProfileScope JADE_PROFILE_CONCAT(_jadeProfileScope, __LINE__)(::jade::Profiler::EventSlot(eventID))
+#else
+	#define JADE_PROFILE_STAGE(stage)   ((void)0)
+	#define JADE_PROFILE_EVENT(eventID) ((void)0)
+#endif
+
+#endif // !JADE_PROFILER_HEADER
\ No newline at end of file
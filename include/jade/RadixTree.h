@@ -0,0 +1,72 @@
+#ifndef JADE_RADIX_TREE_HEADER
+#define JADE_RADIX_TREE_HEADER
+
+#include <jade/Core.h>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+namespace jade {
+	// Compressed prefix tree over strings. Edge labels are ranges of a shared character
+	// arena, splitting an edge only splits its range. Every key carries the value it
+	// was first inserted with.
+	class RadixTree {
+	public:
+		static constexpr uint64_t s_NoValue = UINT64_MAX;
+
+		struct Candidate {
+			std::string key;
+			uint64_t    value = s_NoValue;
+		};
+
+		struct Completion {
+			// The prefix extended as far as all matches agree
+			std::string            completed;
+			std::vector<Candidate> candidates;
+			size_t                 matchCount = 0;
+		};
+
+	public:
+		RadixTree();
+
+	public:
+		void Insert(std::string_view key, uint64_t value = s_NoValue);
+		void Clear();
+
+		uint64_t Find(std::string_view key) const noexcept;
+		inline size_t Size() const noexcept { return m_nodes[0].count; }
+
+		// Cost depends on the prefix and 'maxCandidates', not on the number of keys
+		Completion Complete(std::string_view prefix, size_t maxCandidates) const;
+
+	private:
+		static constexpr uint32_t s_None = UINT32_MAX;
+
+		struct _Node {
+			uint32_t offset      = 0;
+			uint32_t length      = 0;
+			uint32_t firstChild  = s_None;
+			uint32_t nextSibling = s_None;
+			uint32_t count       = 0;  // distinct keys in this subtree
+			bool     isTerminal  = false;
+			uint64_t value       = s_NoValue;
+		};
+
+		inline std::string_view _Label(const _Node& node) const noexcept {
+			return std::string_view(m_chars).substr(node.offset, node.length);
+		}
+
+		// Node whose path spells exactly 'key', s_None if the path ends inside an edge
+		uint32_t _FindNode(std::string_view key) const noexcept;
+		uint32_t _FindChild(uint32_t node, char c, uint32_t* previous = nullptr) const noexcept;
+		void _Collect(uint32_t node, std::string& key, size_t maxCandidates, std::vector<Candidate>& candidates) const;
+
+	private:
+		std::vector<_Node> m_nodes;
+		std::string        m_chars;
+	};
+}
+
+#endif // !JADE_RADIX_TREE_HEADER
\ No newline at end of file
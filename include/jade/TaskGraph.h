@@ -0,0 +1,138 @@
+#ifndef JADE_TASK_GRAPH_HEADER
+#define JADE_TASK_GRAPH_HEADER
+
+#include <jade/Core.h>
+
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <initializer_list>
+
+namespace jade {
+	// DAG of jobs executed on the ThreadPool. A node becomes ready once all of its
+	// dependencies and the children it spawned have finished. The first failing node
+	// cancels the graph, its remaining nodes are skipped and the graph completes with
+	// OnAsyncTaskEnded carrying the first error.
+	class TaskGraph : public std::enable_shared_from_this<TaskGraph> {
+	private:
+		struct _Node;
+
+	public:
+		using NodeID = uint32_t;
+
+		class Context {
+		public:
+			Context(TaskGraph& graph, _Node& node) noexcept : m_graph(graph), m_node(node) {}
+
+		public:
+			// Fraction of this node's own work that is done, in [0, 1]
+			void SetProgress(float progress) noexcept;
+
+			inline bool IsCancelled() const noexcept { return m_graph.m_token.IsCancelled(); }
+			inline const CancellationToken& GetCancellationToken() const noexcept { return m_graph.m_token; }
+
+			// Adds a node that has to finish before the successors of the current node run
+			NodeID AddChild(
+				std::string name,
+				std::function<void(Context&)> function,
+				std::initializer_list<NodeID> dependencies = {},
+				float weight = 1.0f,
+				TaskPriority priority = TaskPriority::Normal
+			);
+
+		private:
+			TaskGraph& m_graph;
+			_Node&     m_node;
+		};
+
+		using Function = std::function<void(Context&)>;
+
+	public:
+		// The graph's token is a child of the task's token, so cancelling the task
+		// cancels the graph
+		static std::shared_ptr<TaskGraph> Create(TaskType type, const std::shared_ptr<FutureTask>& task = nullptr);
+
+		TaskGraph(const TaskGraph&) = delete;
+		TaskGraph& operator=(const TaskGraph&) = delete;
+
+	public:
+		NodeID AddNode(
+			std::string name,
+			Function function,
+			std::initializer_list<NodeID> dependencies = {},
+			float weight = 1.0f,
+			TaskPriority priority = TaskPriority::Normal
+		);
+
+		// Runs from EventSystem::Dispatch on the main thread, for work that touches
+		// state the main thread reads without locking
+		NodeID AddMainThreadNode(
+			std::string name,
+			Function function,
+			std::initializer_list<NodeID> dependencies = {},
+			float weight = 1.0f
+		);
+
+		std::future<void> Launch();
+
+		inline void Cancel() const noexcept { m_token.Cancel(); }
+		inline const CancellationToken& GetCancellationToken() const noexcept { return m_token; }
+
+		// Weighted progress of all nodes added so far, in [0, 1]
+		float GetProgress() const noexcept;
+
+	private:
+		struct _Node {
+			std::string           name;
+			Function              function;
+			float                 weight    = 1.0f;
+			TaskPriority          priority  = TaskPriority::Normal;
+			_Node*                parent    = nullptr;
+			std::vector<_Node*>   successors;
+			std::atomic<uint32_t> remainingDependencies = 0;
+			std::atomic<uint32_t> pendingWork = 1;
+			std::atomic<float>    progress  = 0.0f;
+			bool                  completed = false;
+			bool                  isMainThread = false;
+		};
+
+		TaskGraph(TaskType type, const std::shared_ptr<FutureTask>& task, CancellationToken token);
+
+		NodeID _AddNode(_Node* parent, std::string&& name, Function&& function,
+			std::initializer_list<NodeID> dependencies, float weight, TaskPriority priority, bool isMainThread = false);
+
+		void _Schedule(_Node& node);
+		void _Run(_Node& node);
+		void _SetNodeProgress(_Node& node, float progress) noexcept;
+		void _Fail(const std::string& error);
+		void _FinishWork(_Node& node);
+		void _Complete();
+		void _UpdateTaskProgress() const;
+
+	private:
+		TaskType                    m_type;
+		std::shared_ptr<FutureTask> m_task;
+		CancellationToken           m_token;
+
+		mutable std::mutex                  m_nodesMutex;
+		std::vector<std::unique_ptr<_Node>> m_nodes;
+		bool                                m_launched = false;
+
+		// Sums of all node weights and of their done parts, so progress never scans nodes
+		std::atomic<float> m_totalWeight = 0.0f;
+		std::atomic<float> m_doneWeight  = 0.0f;
+
+		std::atomic<uint32_t> m_pendingNodes = 0;
+		std::promise<void>    m_completion;
+
+		std::mutex  m_errorMutex;
+		std::string m_error;
+		bool        m_failed = false;
+	};
+}
+
+#endif // !JADE_TASK_GRAPH_HEADER
\ No newline at end of file
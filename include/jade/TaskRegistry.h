@@ -0,0 +1,101 @@
+#ifndef JADE_TASK_REGISTRY_HEADER
+#define JADE_TASK_REGISTRY_HEADER
+
+#include <jade/Core.h>
+#include <jade/Event.h>
+
+#include <map>
+#include <array>
+#include <deque>
+#include <vector>
+#include <string>
+#include <future>
+#include <memory>
+#include <functional>
+
+namespace jade {
+	// Main thread only. Tracks every submitted async task by handle, starts at most
+	// the configured number of tasks per TaskType and queues the rest. Nothing here
+	// waits on a future: finished tasks are retired and released once their futures
+	// are ready.
+	class TaskRegistry {
+	public:
+		using TaskID   = uint64_t;
+		using Launcher = std::function<std::future<void>(const std::shared_ptr<FutureTask>&)>;
+
+		static constexpr TaskID s_InvalidID = 0;
+
+		enum class TaskState : uint8_t {
+			Queued,
+			Running,
+			Cancelling
+		};
+
+		enum class CancelResult : uint8_t {
+			NotFound,
+			Dropped,       // was still queued
+			Cancelling,    // running, asked to stop
+			NotCancellable // running and can't be interrupted, e.g. a save
+		};
+
+		struct TaskInfo {
+			TaskID      id       = s_InvalidID;
+			TaskType    type     = TaskType::None;
+			TaskState   state    = TaskState::Queued;
+			float       progress = 0.0f;
+			std::string description;
+		};
+
+	public:
+		TaskRegistry();
+
+		TaskRegistry(const TaskRegistry&) = delete;
+		TaskRegistry& operator=(const TaskRegistry&) = delete;
+
+	public:
+		void SetConcurrencyLimit(TaskType type, size_t limit);
+
+		TaskID Submit(TaskType type, std::string description, Launcher launcher);
+
+		// Queued tasks are dropped, running ones are asked to stop unless their type
+		// is not cancellable. Those are left running to completion.
+		CancelResult Cancel(TaskID id);
+		void CancelAll();
+
+		static inline bool IsCancellable(TaskType type) noexcept { return type < TaskType::AsyncCancellableCount; }
+
+		// Returns the handle of the task the event belongs to, s_InvalidID if unknown.
+		// Takes the event's reference to the task, so it can be released right away.
+		TaskID OnTaskEnded(OnAsyncTaskEnded& endedTask);
+
+		TaskState GetState(TaskID id) const;
+		std::vector<TaskInfo> GetTasks() const;
+		inline size_t GetActiveCount() const noexcept { return m_entries.size(); }
+
+	private:
+		struct _Entry {
+			TaskType                    type  = TaskType::None;
+			TaskState                   state = TaskState::Queued;
+			std::string                 description;
+			Launcher                    launcher;
+			std::shared_ptr<FutureTask> task;
+		};
+
+		void _Launch(TaskID id, _Entry& entry);
+		void _LaunchQueued(TaskType type);
+		void _ReleaseRetired();
+
+	private:
+		static constexpr size_t s_TypeCount = (size_t)TaskType::AsyncCount;
+
+		std::map<TaskID, _Entry>                   m_entries;
+		std::array<std::deque<TaskID>, s_TypeCount> m_queues;
+		std::array<size_t, s_TypeCount>             m_runningCounts = {};
+		std::array<size_t, s_TypeCount>             m_limits = {};
+
+		std::vector<std::shared_ptr<FutureTask>> m_retired;
+		TaskID                                    m_nextID = 1;
+	};
+}
+
+#endif // !JADE_TASK_REGISTRY_HEADER
\ No newline at end of file
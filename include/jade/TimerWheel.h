@@ -0,0 +1,99 @@
+#ifndef JADE_TIMER_WHEEL_HEADER
+#define JADE_TIMER_WHEEL_HEADER
+
+#include <jade/Core.h>
+
+#include <deque>
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace jade {
+	struct TimerHandle {
+		uint32_t index      = UINT32_MAX;
+		uint32_t generation = 0;
+
+		inline bool IsValid() const noexcept { return index != UINT32_MAX; }
+	};
+
+	// Hierarchical timer wheel with 1 ms ticks: 4 levels of 64 slots cover ~4.6 hours,
+	// longer delays are re-armed when they reach the top level. Scheduling and
+	// cancellation are O(1); Advance() jumps straight to the next tick that has
+	// a slot to fire or cascade, so idle ticks cost nothing.
+	class TimerWheel {
+	public:
+		static constexpr uint32_t s_SlotBits     = 6;
+		static constexpr uint32_t s_SlotCount    = 1u << s_SlotBits;
+		static constexpr uint32_t s_LevelCount   = 4;
+		static constexpr uint32_t s_CallbackSize = 320;
+		static constexpr uint64_t s_NoTick       = UINT64_MAX;
+
+		using Callback = Delegate<void(), s_CallbackSize>;
+
+	public:
+		TimerWheel() = default;
+
+		TimerWheel(const TimerWheel&) = delete;
+		TimerWheel& operator=(const TimerWheel&) = delete;
+
+	public:
+		TimerHandle Schedule(uint64_t delayTicks, uint64_t intervalTicks, Callback&& callback);
+		bool Cancel(TimerHandle handle);
+
+		void Advance(uint64_t nowTick);
+
+		inline uint64_t GetCurrentTick() const noexcept { return m_nowTick; }
+		inline uint64_t GetNextEventTick() const noexcept { return m_nextEventTick; }
+		inline size_t GetTimerCount() const noexcept { return m_timerCount; }
+
+	private:
+		enum class _State : uint8_t { Free, Scheduled, Firing, CancelledWhileFiring };
+
+		struct _Timer {
+			uint64_t deadline   = 0;
+			uint64_t interval   = 0;
+			uint32_t generation = 0;
+			uint32_t prev       = UINT32_MAX;
+			uint32_t next       = UINT32_MAX;
+			uint8_t  level      = 0;
+			uint8_t  slot       = 0;
+			_State   state      = _State::Free;
+			Callback callback;
+		};
+
+		uint32_t _Allocate();
+		void _Release(uint32_t index);
+
+		void _Link(uint32_t index);
+		void _Unlink(uint32_t index);
+
+		void _ProcessTick(uint64_t tick);
+		void _Fire(uint32_t index);
+
+		uint64_t _SlotEventTick(uint32_t level, uint32_t slot) const noexcept;
+		uint64_t _ComputeNextEventTick() const noexcept;
+
+	private:
+		std::deque<_Timer>    m_timers;
+		std::vector<uint32_t> m_freeTimers;
+
+		std::array<std::array<uint32_t, s_SlotCount>, s_LevelCount> m_slots = _MakeEmptySlots();
+		std::array<uint64_t, s_LevelCount>                          m_occupied = {};
+
+		uint64_t m_currentTick   = 0;
+		uint64_t m_nowTick       = 0;
+		uint64_t m_nextEventTick = s_NoTick;
+		size_t   m_timerCount    = 0;
+
+	private:
+		static constexpr std::array<std::array<uint32_t, s_SlotCount>, s_LevelCount> _MakeEmptySlots() {
+			std::array<std::array<uint32_t, s_SlotCount>, s_LevelCount> slots = {};
+			for (auto& level : slots) {
+				level.fill(UINT32_MAX);
+			}
+			return slots;
+		}
+	};
+}
+
+#endif // !JADE_TIMER_WHEEL_HEADER
\ No newline at end of file
@@ -0,0 +1,106 @@
+#ifndef JADE_TRACE_HEADER
+#define JADE_TRACE_HEADER
+
+#include <jade/Core.h>
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <filesystem>
+
+namespace jade {
+	enum class TraceRecordType : uint8_t {
+		Begin,
+		End,
+		Instant
+	};
+
+	// Records begin/end/instant marks into per-thread rings: each thread only writes
+	// its own buffer, so recording is wait-free. Names must outlive the tracer
+	// (string literals). Old records are overwritten once a ring is full.
+	class Tracer {
+	public:
+		static constexpr size_t s_BufferCapacity = 1 << 14;
+
+	public:
+		Tracer();
+
+		Tracer(const Tracer&) = delete;
+		Tracer& operator=(const Tracer&) = delete;
+
+		static Tracer& Get() noexcept;
+
+		static constexpr bool IsEnabled() noexcept {
+		#ifdef JADE_ENABLE_TRACING
+			return true;
+		#else
+			return false;
+		#endif
+		}
+
+	public:
+		void Record(TraceRecordType type, const char* name) noexcept;
+		inline void Begin(const char* name) noexcept { Record(TraceRecordType::Begin, name); }
+		inline void End(const char* name) noexcept { Record(TraceRecordType::End, name); }
+		inline void Instant(const char* name) noexcept { Record(TraceRecordType::Instant, name); }
+
+		// Shown as the track name of the calling thread in the trace viewer
+		void SetThreadName(const char* name);
+
+		// Writes a Chrome trace-event JSON file (chrome://tracing, ui.perfetto.dev)
+		void DumpChromeTrace(const std::filesystem::path& path) const;
+
+	private:
+		struct _Record {
+			std::atomic<uint64_t>        timestamp = 0;
+			std::atomic<const char*>     name = nullptr;
+			std::atomic<TraceRecordType> type = TraceRecordType::Instant;
+		};
+
+		struct _ThreadBuffer {
+			std::unique_ptr<_Record[]> records = std::make_unique<_Record[]>(s_BufferCapacity);
+			std::atomic<uint64_t>      head = 0;
+			std::atomic<const char*>   threadName = nullptr;
+			uint32_t                   threadID = 0;
+		};
+
+		_ThreadBuffer& _GetThreadBuffer();
+
+	private:
+		std::chrono::steady_clock::time_point m_epoch;
+
+		mutable std::mutex                          m_buffersMutex;
+		std::vector<std::unique_ptr<_ThreadBuffer>> m_buffers;
+	};
+
+	class TraceScope {
+	public:
+		explicit TraceScope(const char* name) noexcept : m_name(name) { Tracer::Get().Begin(name); }
+		~TraceScope() { Tracer::Get().End(m_name); }
+
+		TraceScope(const TraceScope&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+
+	private:
+		const char* m_name;
+	};
+}
+
+#define JADE_TRACE_CONCAT_IMPL(a, b) a##b
+#define JADE_TRACE_CONCAT(a, b) JADE_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef JADE_ENABLE_TRACING
+	#define JADE_TRACE_SCOPE(name)   ::jade::TraceScope JADE_TRACE_CONCAT(_jadeTraceScope, __LINE__)(name)
+	#define JADE_TRACE_INSTANT(name) ::jade::Tracer::Get().Instant(name)
+	#define JADE_TRACE_THREAD(name)  ::jade::Tracer::Get().SetThreadName(name)
+#else
+	#define JADE_TRACE_SCOPE(name)   ((void)0)
+	#define JADE_TRACE_INSTANT(name) ((void)0)
+	#define JADE_TRACE_THREAD(name)  ((void)0)
+#endif
+
+#endif // !JADE_TRACE_HEADER
\ No newline at end of file
@@ -1,9 +1,11 @@
 #ifndef JADE_AUDIO_HEADER
 #define JADE_AUDIO_HEADER
 
+#include <span>
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
 
 namespace jade {
 	class Audio {
@@ -16,7 +18,11 @@ namespace jade {
 		virtual ~IAudioStream() = default;
 
 		virtual bool Initialize(const std::string& audioPath, double seconds) = 0;
-		virtual std::vector<float> Read(size_t chunkSize) = 0;
+
+		// Fills 'out' with interleaved frames of GetChannelCount() samples and returns
+		// how many frames were written. Fewer frames than fit means the stream ended.
+		virtual size_t Read(std::span<float> out) = 0;
+
 		virtual size_t GetSampleRate() const = 0;
 		virtual uint32_t GetChannelCount() const = 0;
 
@@ -27,14 +33,16 @@ namespace jade {
 		inline std::shared_ptr<_BaseImpl> _GetBaseImpl(IAudioStream* other) { return other->m_baseImpl; }
 	};
 
+	// Decodes a file into interleaved f32 frames. Zero channels or sample rate keep the
+	// file's own, MP3 encoder delay and padding from a LAME tag are trimmed off.
 	class AudioStream final : public IAudioStream {
 	public:
-		AudioStream();
+		explicit AudioStream(uint32_t channelCount = 0, uint32_t sampleRate = 0);
 		~AudioStream();
 
 	public:
 		virtual bool Initialize(const std::string& audioPath, double seconds) override;
-		virtual std::vector<float> Read(size_t chunkSize) override;
+		virtual size_t Read(std::span<float> out) override;
 		virtual size_t GetSampleRate() const override;
 		virtual uint32_t GetChannelCount() const override;
 
@@ -55,6 +63,8 @@ namespace jade {
 		std::shared_ptr<IAudioStream> m_stream;
 	};
 
+	// Plays the wrapped stream 'speed' times faster by linear interpolation, the
+	// source frames are read into a scratch buffer that only grows
 	class AudioStreamSpeeded : public IAudioStreamEffect {
 	public:
 		AudioStreamSpeeded(const std::shared_ptr<IAudioStream>& stream, double speed);
@@ -62,7 +72,7 @@ namespace jade {
 
 	public:
 		virtual bool Initialize(const std::string& audioPath, double seconds) override;
-		virtual std::vector<float> Read(size_t chunkSize) override;
+		virtual size_t Read(std::span<float> out) override;
 		virtual size_t GetSampleRate() const override;
 		virtual uint32_t GetChannelCount() const override;
 
@@ -71,6 +81,12 @@ namespace jade {
 	private:
 		double m_speed;
 
+		// Position of the next output frame in the scratch buffer, whose first
+		// m_carriedFrames frames are left over from the previous read
+		double             m_position      = 0.0;
+		size_t             m_carriedFrames = 0;
+		std::vector<float> m_scratch;
+
 		struct _Impl;
 		std::unique_ptr<_Impl> m_impl;
 	};
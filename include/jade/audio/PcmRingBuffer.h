@@ -0,0 +1,46 @@
+#ifndef JADE_AUDIO_PCM_RING_BUFFER_HEADER
+#define JADE_AUDIO_PCM_RING_BUFFER_HEADER
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+namespace jade {
+	// Lock-free single producer, single consumer queue of interleaved samples. The
+	// capacity is rounded up to a power of two, positions only grow and are masked on
+	// access, so neither side ever waits for the other.
+	class PcmRingBuffer {
+	public:
+		PcmRingBuffer() = default;
+		explicit PcmRingBuffer(size_t capacity);
+
+		PcmRingBuffer(const PcmRingBuffer&) = delete;
+		PcmRingBuffer& operator=(const PcmRingBuffer&) = delete;
+
+	public:
+		// Neither side may run while the buffer is resized or cleared
+		void Reset(size_t capacity);
+		void Clear() noexcept;
+
+		inline size_t GetCapacity() const noexcept { return m_mask + 1; }
+
+		// Producer side, returns how many samples fit
+		size_t Write(const float* samples, size_t count) noexcept;
+		size_t GetWritable() const noexcept;
+		inline size_t GetWritePosition() const noexcept { return m_writePosition.load(std::memory_order_relaxed); }
+
+		// Consumer side, returns how many samples were available
+		size_t Read(float* samples, size_t count) noexcept;
+		size_t GetReadable() const noexcept;
+		inline size_t GetReadPosition() const noexcept { return m_readPosition.load(std::memory_order_relaxed); }
+
+	private:
+		size_t                   m_mask = 0;
+		std::unique_ptr<float[]> m_samples;
+
+		alignas(64) std::atomic<size_t> m_writePosition{ 0 };
+		alignas(64) std::atomic<size_t> m_readPosition{ 0 };
+	};
+}
+
+#endif // !JADE_AUDIO_PCM_RING_BUFFER_HEADER
\ No newline at end of file
@@ -9,12 +9,29 @@ namespace jade {
 	public:
 		struct Impl;
 
-		Player();
+		enum class Device {
+			Default,
+			Null // miniaudio's null backend, consumes audio in real time without output
+		};
+
+		explicit Player(Device device = Device::Default);
 		~Player();
 
 	public:
 		bool IsPlaying() const;
+
+		// Replaces the play queue with 'track'
 		void Play(const MusicLibrary::TrackElement& track);
+
+		// Plays 'track' right after the queued ones without a gap, or now when idle
+		void Enqueue(const MusicLibrary::TrackElement& track);
+
+		// Jumps to the next queued track, false if there is none
+		bool Skip();
+
+		// Tracks waiting behind the one being played
+		size_t GetQueueSize() const;
+
 		void Resume();
 		void Pause();
 		void SetVolume(float volume);
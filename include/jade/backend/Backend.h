@@ -10,6 +10,18 @@ namespace jade {
 
 		virtual void Update(Timestep deltaTime) = 0;
 		virtual void Render() = 0;
+
+		// Main loop only blocks for new input/events when nothing is left to process
+		virtual bool HasPendingWork() const = 0;
+
+		// Only a backend reading the terminal as keys enables the input system, which
+		// puts the terminal into raw mode. Others leave stdin as it is.
+		virtual bool ReadsKeyInput() const { return false; }
+
+		// Tasks may still be waiting to resume on the main thread when the application
+		// is destroyed, it keeps dispatching after the cancel until none is running
+		virtual void CancelTasks() {}
+		virtual bool HasRunningTasks() const { return false; }
 	};
 }
 
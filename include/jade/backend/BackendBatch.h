@@ -0,0 +1,58 @@
+#ifndef JADE_BACKEND_BATCH_HEADER
+#define JADE_BACKEND_BATCH_HEADER
+
+#include <jade/Core.h>
+#include <jade/Config.h>
+#include <jade/backend/CommandBackend.h>
+
+#include <chrono>
+#include <string>
+#include <istream>
+#include <fstream>
+#include <filesystem>
+
+namespace jade {
+	// Runs a command script without a terminal, one line per command. Empty lines and
+	// lines starting with '#' are skipped. A command is finished once the tasks it
+	// started have ended, only then the next line is read. Command output goes to
+	// stdout, the status and duration of every command to stderr. After the last line
+	// the application closes with exit code 1 if any command failed, 0 otherwise.
+	class BackendBatch : public CommandBackend {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+	public:
+		// An empty path reads the script from stdin
+		explicit BackendBatch(const std::filesystem::path& script = Config::Paths::BatchScript);
+
+	public:
+		virtual void Update(Timestep) override;
+		virtual void Render() override;
+		virtual bool HasPendingWork() const override;
+
+		virtual std::ostream& Out() override;
+
+	private:
+		bool _IsCommandRunning() const noexcept;
+		void _FinishCommand();
+		void _Finish();
+
+	private:
+		std::ifstream m_file;
+		std::istream* m_input = nullptr;
+		bool          m_isFinished = false;
+
+		std::string m_command;
+		size_t      m_lineNumber = 0;
+		bool        m_hasCommand = false;
+		bool        m_isCommandExecuted = false;
+		size_t      m_errorCountBefore = 0;
+
+		size_t            m_commandCount = 0;
+		size_t            m_failedCount = 0;
+		Clock::time_point m_commandStart;
+		Clock::time_point m_batchStart;
+	};
+}
+
+#endif // !JADE_BACKEND_BATCH_HEADER
\ No newline at end of file
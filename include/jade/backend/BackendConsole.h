@@ -3,41 +3,24 @@
 
 #include <jade/Core.h>
 #include <jade/Event.h>
-#include <jade/MusicLibrary.h>
-#include <jade/backend/Backend.h>
+#include <jade/Config.h>
+#include <jade/RadixTree.h>
+#include <jade/backend/CommandBackend.h>
+#include <jade/backend/ConsoleRenderer.h>
+#include <jade/backend/CommandHistory.h>
 
 #include <queue>
 #include <vector>
 #include <string>
 #include <memory>
 #include <variant>
+#include <string_view>
 
 namespace jade {
-	class BackendConsole : public IBackend {
+	class BackendConsole : public CommandBackend {
 	public:
-		enum State : uint64_t {
-			ShouldShowNewInputBit     = 0x1,
-			ShouldTerminateBit        = 0x4,
-			AllTasksCancelledBit      = 0x8,
-		};
-
-		enum class Command {
-			Close,
-			CloseUnsaved,
-
-			LibraryShow,
-			LibrarySave,
-			LibraryAdd,
-
-			Play,
-			Pause,
-			Resume,
-			Volume,
-			Speed,
-
-			PlaylistCreate,
-
-			None
+		enum ConsoleState : uint64_t {
+			ReverseSearchBit          = 0x20,
 		};
 
 		struct Task {
@@ -45,7 +28,6 @@ namespace jade {
 			enum class Type {
 				KeyAction,
 				Execute,
-				RerenderCommandLine,
 
 				None
 			};
@@ -55,14 +37,9 @@ namespace jade {
 				std::string cmd;
 			};
 
-			struct RerenderCommandLine {
-				size_t prevSize = 0;
-			};
-
 			using Payload = std::variant<
 				OnKeyAction,
-				ExecuteCmd,
-				RerenderCommandLine
+				ExecuteCmd
 			>;
 
 		public:
@@ -71,68 +48,60 @@ namespace jade {
 			Payload      payload  = {};
 		};
 
+	public:
+		static constexpr std::string_view s_Prompt = "<Jade> ";
+		static constexpr size_t s_MaxCompletionCandidates = 16;
+
 	public:
 		BackendConsole();
 
 	public:
 		virtual void Update(Timestep) override;
 		virtual void Render() override;
+		virtual bool HasPendingWork() const override;
 
-	public:
-		void ShowNewInput() const;
-		size_t ShowNewInputCharSize() const noexcept;
-		void ShowError(const std::string&) const;
+		virtual bool ReadsKeyInput() const override { return true; }
+
+		virtual std::ostream& Out() override { return m_renderer.Out(); }
 
 	public:
 		void DispatchTask(const Task& task);
-		void DispatchTaskResult(const OnTaskEnded& endedTask) const;
-		void DispatchTaskResult(const OnAsyncTaskEnded& endedTask) const;
 
 		void KeyActionTask(const Task& task);
 		void ExecuteCmdTask(const Task& task);
-		void RerenderCommandLineTask(const Task& task);
 
-		void DispatchCmdExecution(const Task& task);
-
-		void ExecuteCloseCmd(std::vector<std::vector<std::string>>&);
-		void ExecuteCloseUnsavedCmd(std::vector<std::vector<std::string>>&);
-		void ExecuteLibraryShowCmd(std::vector<std::vector<std::string>>&);
-		void ExecuteLibrarySaveCmd(std::vector<std::vector<std::string>>&);
-		void ExecuteLibraryAddCmd(std::vector<std::vector<std::string>>&);
-		void ExecutePlayCmd(std::vector<std::vector<std::string>>&);
-		void ExecutePauseCmd(std::vector<std::vector<std::string>>&);
-		void ExecuteResumeCmd(std::vector<std::vector<std::string>>&);
-		void ExecuteVolumeCmd(std::vector<std::vector<std::string>>&);
-		void ExecuteSpeedCmd(std::vector<std::vector<std::string>>&);
+	private:
+		// Tab completion of the word before the cursor
+		void _CompleteInput();
+		void _CompletePath(size_t wordStart);
+		void _CompleteTrackID(size_t valueStart, std::string_view value);
+		void _ApplyCompletion(size_t wordStart, const RadixTree::Completion& completion,
+			std::string_view uniqueSuffix, bool showValues = false);
+
+		void _SubmitInput();
+		void _BrowseHistory(bool older, size_t steps);
+		void _BeginReverseSearch();
+		void _ReverseSearchKey(const OnKeyAction& keyAction);
+		void _EndReverseSearch(bool accept);
 
 	private:
-		uint64_t         m_states = (uint64_t)State::ShouldShowNewInputBit;
 		size_t			 m_cursorPosition = 0;
 		std::string      m_commandBuffer;
 		std::queue<Task> m_taskQueue;
 		
-		size_t m_workingTaskCount = 0;
-		std::shared_ptr<FutureTask> m_futureTasks[(size_t)TaskType::AsyncCancellableCount] = {};
+		ConsoleRenderer m_renderer;
+		RadixTree       m_commandNames;
 
-		MusicLibraryProxy m_musicLibrary{ MusicLibraryProxy::Attachment::Cache };
+		CommandHistory m_history{ Config::Paths::HistoryFile };
+		size_t         m_historyPosition = 0;
+		std::string    m_editedInput;
+		std::string    m_searchQuery;
+		std::string    m_searchPrompt;
+		size_t         m_searchMatch = CommandHistory::s_NotFound;
 
 		std::vector<void(BackendConsole::*)(const Task&)> m_dispatchTaskTable = {
 			&BackendConsole::KeyActionTask,
 			&BackendConsole::ExecuteCmdTask,
-			&BackendConsole::RerenderCommandLineTask,
-		};
-
-		std::vector<void(BackendConsole::*)(std::vector<std::vector<std::string>>&)> m_dispatchCmdTable = {
-			&BackendConsole::ExecuteCloseCmd,
-			&BackendConsole::ExecuteCloseUnsavedCmd,
-			&BackendConsole::ExecuteLibraryShowCmd,
-			&BackendConsole::ExecuteLibrarySaveCmd,
-			&BackendConsole::ExecuteLibraryAddCmd,
-			&BackendConsole::ExecutePlayCmd,
-			&BackendConsole::ExecutePauseCmd,
-			&BackendConsole::ExecuteResumeCmd,
-			&BackendConsole::ExecuteVolumeCmd,
-			&BackendConsole::ExecuteSpeedCmd,
 		};
 	};
 }
@@ -0,0 +1,93 @@
+#ifndef JADE_BACKEND_SOCKET_HEADER
+#define JADE_BACKEND_SOCKET_HEADER
+
+#include <jade/Core.h>
+#include <jade/Config.h>
+#include <jade/backend/CommandBackend.h>
+
+#include <map>
+#include <string>
+#include <sstream>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+
+namespace jade {
+	// Serves newline-delimited commands over a Unix domain socket, clients are
+	// multiplexed with epoll on the main thread. The reply to a command is its output
+	// followed by a line holding a single '.', output that belongs to no command, such
+	// as finished tasks, is sent between replies with every line prefixed by "* ".
+	// Task results and library pages go to the client that asked for them.
+	class BackendSocket : public CommandBackend {
+	public:
+		using ClientID = uint64_t;
+
+		static constexpr ClientID s_NoClient = 0;
+
+		static constexpr size_t s_ReadChunkSize     = 4096;
+		static constexpr size_t s_MaxReadPerUpdate  = 64 * 1024;
+		static constexpr size_t s_MaxLineSize       = 64 * 1024;
+		static constexpr size_t s_MaxPendingOutput  = 4 * 1024 * 1024;
+		static constexpr int    s_MaxEventsPerWait  = 64;
+		static constexpr int    s_ListenBacklog     = 16;
+
+	public:
+		explicit BackendSocket(const std::filesystem::path& path = Config::Paths::ControlSocket);
+		~BackendSocket();
+
+		BackendSocket(const BackendSocket&) = delete;
+		BackendSocket& operator=(const BackendSocket&) = delete;
+
+	public:
+		virtual void Update(Timestep) override;
+		virtual void Render() override;
+		virtual bool HasPendingWork() const override;
+
+		virtual std::ostream& Out() override;
+
+	protected:
+		virtual void _OnTaskSubmitted(TaskRegistry::TaskID id) override;
+		virtual void _SetTaskOutput(TaskRegistry::TaskID id) override;
+
+	private:
+		struct _Client {
+			int                fd = -1;
+			std::string        input;  // received bytes after the last complete line
+			std::string        output; // bytes the socket has not accepted yet
+			std::ostringstream events;
+			bool               isWaitingWritable = false;
+			bool               isClosing = false; // peer stopped sending, closed once output drains
+		};
+
+		using _ClientIterator = std::map<ClientID, _Client>::iterator;
+
+		void _Accept();
+		bool _Receive(ClientID id, _Client& client);
+		bool _Send(ClientID id, _Client& client);
+		void _ExecuteLine(ClientID id, _Client& client, std::string_view line);
+		_ClientIterator _Close(_ClientIterator it);
+		void _Shutdown() noexcept;
+
+		static void _AppendEvents(std::string& output, std::string_view events);
+
+	private:
+		std::filesystem::path m_path;
+		int                   m_listenFd = -1;
+		int                   m_epollFd = -1;
+
+		std::map<ClientID, _Client> m_clients;
+		ClientID                    m_nextClientID = 1;
+
+		// Where Out() goes: the reply of the command being executed, events of a
+		// client or, with neither set, every client
+		ClientID           m_replyClient = s_NoClient;
+		ClientID           m_eventClient = s_NoClient;
+		std::ostringstream m_reply;
+		std::ostringstream m_broadcast;
+
+		std::unordered_map<TaskRegistry::TaskID, ClientID> m_taskClients;
+		ClientID                                           m_viewClient = s_NoClient;
+	};
+}
+
+#endif // !JADE_BACKEND_SOCKET_HEADER
\ No newline at end of file
@@ -0,0 +1,154 @@
+#ifndef JADE_COMMAND_BACKEND_HEADER
+#define JADE_COMMAND_BACKEND_HEADER
+
+#include <jade/Core.h>
+#include <jade/Event.h>
+#include <jade/MusicLibrary.h>
+#include <jade/TaskRegistry.h>
+#include <jade/backend/Backend.h>
+#include <jade/backend/CommandParser.h>
+#include <jade/backend/LibraryView.h>
+
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <ostream>
+#include <string_view>
+
+namespace jade {
+	// Base of the backends driven by text commands. It owns the command table, the
+	// handlers and the tasks they start, derived backends decide where command lines
+	// come from and where the output goes.
+	class CommandBackend : public IBackend {
+	public:
+		enum State : uint64_t {
+			ShouldTerminateBit        = 0x4,
+			AllTasksCancelledBit      = 0x8,
+			LibraryViewPendingBit     = 0x10,
+		};
+
+		enum class Command {
+			Close,
+			CloseUnsaved,
+
+			LibraryShow,
+			LibraryNext,
+			LibraryPrev,
+			LibrarySave,
+			LibraryAdd,
+			LibraryImport,
+
+			Play,
+			Pause,
+			Resume,
+			Volume,
+			Speed,
+			Enqueue,
+			Next,
+
+			Stats,
+			TraceDump,
+
+			Tasks,
+			CancelTask,
+
+			PlaylistCreate,
+
+			None
+		};
+
+		struct CommandSpec {
+			Command               command = Command::None;
+			CommandParser::Schema params;
+		};
+
+	public:
+		CommandBackend();
+
+	public:
+		static const std::map<std::string_view, CommandSpec>& GetCommands() noexcept;
+
+	public:
+		// Stream the output of the command or event being handled goes to
+		virtual std::ostream& Out() = 0;
+
+		void ShowError(const std::string&);
+
+		virtual void CancelTasks() override;
+		virtual bool HasRunningTasks() const override { return m_tasks.GetActiveCount() > 0; }
+
+	public:
+		void DispatchTaskResult(const OnTaskEnded& endedTask);
+		void DispatchTaskResult(const OnAsyncTaskEnded& endedTask);
+
+		// Parses the line, binds it to the command's schema and runs its handler. False
+		// when the line names no runnable command or its parameters don't bind.
+		bool ExecuteCommand(std::string_view cmd);
+
+		void ExecuteCloseCmd(const CommandParser::Arguments&);
+		void ExecuteCloseUnsavedCmd(const CommandParser::Arguments&);
+		void ExecuteLibraryShowCmd(const CommandParser::Arguments&);
+		void ExecuteLibraryNextCmd(const CommandParser::Arguments&);
+		void ExecuteLibraryPrevCmd(const CommandParser::Arguments&);
+		void ExecuteLibrarySaveCmd(const CommandParser::Arguments&);
+		void ExecuteLibraryAddCmd(const CommandParser::Arguments&);
+		void ExecuteLibraryImportCmd(const CommandParser::Arguments&);
+		void ExecutePlayCmd(const CommandParser::Arguments&);
+		void ExecutePauseCmd(const CommandParser::Arguments&);
+		void ExecuteResumeCmd(const CommandParser::Arguments&);
+		void ExecuteVolumeCmd(const CommandParser::Arguments&);
+		void ExecuteSpeedCmd(const CommandParser::Arguments&);
+		void ExecuteEnqueueCmd(const CommandParser::Arguments&);
+		void ExecuteNextCmd(const CommandParser::Arguments&);
+		void ExecuteStatsCmd(const CommandParser::Arguments&);
+		void ExecuteTraceDumpCmd(const CommandParser::Arguments&);
+		void ExecuteTasksCmd(const CommandParser::Arguments&);
+		void ExecuteCancelTaskCmd(const CommandParser::Arguments&);
+		void ExecutePlaylistCreateCmd(const CommandParser::Arguments&);
+
+	protected:
+		// Hooks for backends that route output per origin. Output written between
+		// _SetTaskOutput(id) and _SetTaskOutput(s_InvalidID) reports the end of that task.
+		virtual void _OnTaskSubmitted(TaskRegistry::TaskID) {}
+		virtual void _SetTaskOutput(TaskRegistry::TaskID) {}
+
+		void _SubmitTask(TaskType type, std::string description, TaskRegistry::Launcher&& launcher);
+		void _UpdateLibraryView();
+		void _ShowLibraryPage();
+
+	protected:
+		uint64_t      m_states = 0;
+		size_t        m_errorCount = 0; // errors shown since construction
+		TaskRegistry  m_tasks;
+		CommandParser m_commandParser;
+
+		MusicLibraryProxy m_musicLibrary{ MusicLibraryProxy::Attachment::Cache };
+		LibraryView       m_libraryView;
+
+		std::vector<void(CommandBackend::*)(const CommandParser::Arguments&)> m_dispatchCmdTable = {
+			&CommandBackend::ExecuteCloseCmd,
+			&CommandBackend::ExecuteCloseUnsavedCmd,
+			&CommandBackend::ExecuteLibraryShowCmd,
+			&CommandBackend::ExecuteLibraryNextCmd,
+			&CommandBackend::ExecuteLibraryPrevCmd,
+			&CommandBackend::ExecuteLibrarySaveCmd,
+			&CommandBackend::ExecuteLibraryAddCmd,
+			&CommandBackend::ExecuteLibraryImportCmd,
+			&CommandBackend::ExecutePlayCmd,
+			&CommandBackend::ExecutePauseCmd,
+			&CommandBackend::ExecuteResumeCmd,
+			&CommandBackend::ExecuteVolumeCmd,
+			&CommandBackend::ExecuteSpeedCmd,
+			&CommandBackend::ExecuteEnqueueCmd,
+			&CommandBackend::ExecuteNextCmd,
+			&CommandBackend::ExecuteStatsCmd,
+			&CommandBackend::ExecuteTraceDumpCmd,
+			&CommandBackend::ExecuteTasksCmd,
+			&CommandBackend::ExecuteCancelTaskCmd,
+			&CommandBackend::ExecutePlaylistCreateCmd,
+		};
+	};
+}
+
+#endif // !JADE_COMMAND_BACKEND_HEADER
\ No newline at end of file
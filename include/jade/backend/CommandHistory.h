@@ -0,0 +1,59 @@
+#ifndef JADE_COMMAND_HISTORY_HEADER
+#define JADE_COMMAND_HISTORY_HEADER
+
+#include <jade/Core.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+
+namespace jade {
+	// Entered commands, oldest first, backed by an append-only file with one command
+	// per line. Substring searches go through a trigram index, so they only verify
+	// entries that contain the rarest trigram of the query.
+	class CommandHistory {
+	public:
+		static constexpr size_t s_NotFound = SIZE_MAX;
+
+	public:
+		CommandHistory() = default;
+		explicit CommandHistory(const std::filesystem::path& path);
+
+		CommandHistory(const CommandHistory&) = delete;
+		CommandHistory& operator=(const CommandHistory&) = delete;
+
+	public:
+		// Loads the file and keeps it open for appending
+		void Open(const std::filesystem::path& path);
+
+		// Repeating the newest entry is not recorded
+		void Append(std::string_view command);
+
+		inline size_t Size() const noexcept { return m_offsets.size(); }
+		std::string_view Get(size_t index) const noexcept;
+
+		// Newest entry below 'before' that contains 'query', s_NotFound if none
+		size_t FindOlder(std::string_view query, size_t before) const;
+
+	private:
+		using _Trigram = uint32_t;
+
+		static _Trigram _MakeTrigram(std::string_view text, size_t position) noexcept;
+
+		void _Add(std::string_view command);
+
+	private:
+		std::string           m_chars;
+		std::vector<uint64_t> m_offsets;
+		std::fstream          m_file;
+
+		// Entry indices per trigram, ascending and without repeats
+		std::unordered_map<_Trigram, std::vector<uint32_t>> m_index;
+	};
+}
+
+#endif // !JADE_COMMAND_HISTORY_HEADER
\ No newline at end of file
@@ -0,0 +1,101 @@
+#ifndef JADE_COMMAND_PARSER_HEADER
+#define JADE_COMMAND_PARSER_HEADER
+
+#include <jade/Core.h>
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+namespace jade {
+	// Single pass parser for lines like "command pack: value, value; pack: value;".
+	// Tokens are views into the parsed line, all storage is reused between lines, so
+	// a line that parses and binds allocates nothing once the buffers have grown.
+	class CommandParser {
+	public:
+		enum class ValueType : uint8_t {
+			String,   // exactly one value
+			List,     // one or more values
+			Unsigned,
+			Number
+		};
+
+		// What the console completes the values of a pack with
+		enum class ValueSource : uint8_t {
+			None,
+			Path,
+			ArtistName,
+			TrackName,
+			TrackID    // a track name is completed and replaced with the track's ID
+		};
+
+		// Declares one parameter pack of a command, 'name' includes the trailing ':'
+		struct Param {
+			std::string_view name;
+			ValueType        type       = ValueType::String;
+			bool             isRequired = false;
+			ValueSource      source     = ValueSource::None;
+		};
+
+		using Schema = std::span<const Param>;
+
+		// Arguments bound to a schema, valid until the next Parse
+		class Arguments {
+		public:
+			bool Has(std::string_view name) const noexcept;
+
+			std::string_view GetString(std::string_view name, std::string_view fallback = {}) const noexcept;
+			std::span<const std::string_view> GetList(std::string_view name) const noexcept;
+			uint64_t GetUnsigned(std::string_view name, uint64_t fallback = 0) const noexcept;
+			double GetNumber(std::string_view name, double fallback = 0.0) const noexcept;
+
+		private:
+			friend class CommandParser;
+
+			struct _Value {
+				std::span<const std::string_view> values;
+				uint64_t unsignedValue = 0;
+				double   numberValue   = 0.0;
+				bool     isSet         = false;
+			};
+
+			const _Value* _Find(std::string_view name) const noexcept;
+
+		private:
+			Schema              m_schema;
+			std::vector<_Value> m_values;
+		};
+
+	public:
+		// Splits the line into the command name and its packs, false on a syntax error
+		bool Parse(std::string_view line);
+
+		// Checks the parsed packs against the schema and converts their values, false
+		// on unknown, repeated, missing or malformed packs
+		bool Bind(Schema schema);
+
+		inline std::string_view GetCommandName() const noexcept { return m_command; }
+		inline const Arguments& GetArguments() const noexcept { return m_arguments; }
+		inline const std::string& GetError() const noexcept { return m_error; }
+
+	private:
+		struct _Pack {
+			std::string_view name;
+			uint32_t         first = 0;
+			uint32_t         count = 0;
+		};
+
+		bool _Fail(std::string_view message, std::string_view pack = {}, std::string_view suffix = {});
+
+	private:
+		std::string_view              m_command;
+		std::vector<_Pack>            m_packs;
+		std::vector<std::string_view> m_values;
+		Arguments                     m_arguments;
+		std::string                   m_error;
+	};
+}
+
+#endif // !JADE_COMMAND_PARSER_HEADER
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef JADE_CONSOLE_RENDERER_HEADER
+#define JADE_CONSOLE_RENDERER_HEADER
+
+#include <jade/Core.h>
+
+#include <string>
+#include <sstream>
+#include <string_view>
+
+namespace jade {
+	// Composes a console frame out of the text printed since the last frame and the
+	// input line below it. Present diffs the input line against the one currently on
+	// screen and writes the whole frame with a single write.
+	class ConsoleRenderer {
+	public:
+		ConsoleRenderer() = default;
+		~ConsoleRenderer();
+
+		ConsoleRenderer(const ConsoleRenderer&) = delete;
+		ConsoleRenderer& operator=(const ConsoleRenderer&) = delete;
+
+	public:
+		// Text printed above the input line, buffered until the next Present
+		inline std::ostream& Out() noexcept { return m_output; }
+
+		// 'cursor' is an offset into 'text'
+		void SetInputLine(std::string_view prompt, std::string_view text, size_t cursor);
+
+		bool IsDirty() const noexcept;
+
+		void Present();
+
+	private:
+		void _MoveCursor(size_t from, size_t to);
+		void _Write();
+
+	private:
+		std::ostringstream m_output;
+		std::string        m_frame;
+
+		std::string m_inputLine;
+		size_t      m_inputCursor = 0;
+
+		std::string m_shownLine;
+		size_t      m_shownCursor = 0;
+		bool        m_isLineShown = false;
+	};
+}
+
+#endif // !JADE_CONSOLE_RENDERER_HEADER
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef JADE_LIBRARY_VIEW_HEADER
+#define JADE_LIBRARY_VIEW_HEADER
+
+#include <jade/MusicLibrary.h>
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+namespace jade {
+	// Paged, sorted view over a snapshot of the track list. The snapshot is an index
+	// of iterators built in chunks across updates, and only the pages that are shown
+	// get sorted.
+	class LibraryView {
+	public:
+		enum class SortKey : uint8_t {
+			ID,
+			Name,
+			Artist,
+			Duration
+		};
+
+		static constexpr size_t s_DefaultPageSize = 20;
+		static constexpr size_t s_MaxPageSize     = 500;
+		static constexpr size_t s_IndexChunkSize  = 65536;
+
+	public:
+		// 'page' is clamped once the snapshot is complete
+		void Open(const MusicLibraryProxy& library, SortKey key, bool descending, size_t pageSize, size_t page = 0);
+		inline void Close() noexcept { m_isOpen = false; m_tracks.clear(); }
+		inline bool IsOpen() const noexcept { return m_isOpen; }
+
+		// Indexes the next chunk of tracks, returns true once the snapshot is complete
+		bool Update();
+		inline bool IsReady() const noexcept { return m_isOpen && m_next == m_end; }
+
+		// Clamped to the last page
+		void SetPage(size_t page) noexcept;
+		inline size_t GetPage() const noexcept { return m_page; }
+		inline size_t GetPageCount() const noexcept { return (m_tracks.size() + m_pageSize - 1) / m_pageSize; }
+		inline size_t GetTrackCount() const noexcept { return m_tracks.size(); }
+
+		// Tracks of the current page in view order, only valid once ready
+		std::span<const MusicLibrary::TrackIterator> GetVisibleTracks();
+
+	private:
+		bool _Less(const MusicLibrary::TrackIterator& left, const MusicLibrary::TrackIterator& right) const;
+
+	private:
+		std::vector<MusicLibrary::TrackIterator> m_tracks;
+		MusicLibrary::TrackIterator              m_next;
+		MusicLibrary::TrackIterator              m_end;
+
+		SortKey m_sortKey    = SortKey::ID;
+		bool    m_descending = false;
+		bool    m_isOpen     = false;
+
+		size_t m_page     = 0;
+		size_t m_pageSize = s_DefaultPageSize;
+
+		// m_tracks[0, m_orderedCount) holds the smallest tracks in final order
+		size_t m_orderedCount = 0;
+	};
+}
+
+#endif // !JADE_LIBRARY_VIEW_HEADER
\ No newline at end of file
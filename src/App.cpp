@@ -1,14 +1,21 @@
 #include <jade/App.h>
 #include <jade/backend/BackendConsole.h>
+#include <jade/backend/BackendSocket.h>
+#include <jade/backend/BackendBatch.h>
+
+#include <jade/Platform.h>
+#include <jade/Profiler.h>
+#include <jade/Trace.h>
 
-#include <thread>
 #include <stdexcept>
 
 namespace {
 	jade::Application* g_Application = nullptr;
 }
 
-jade::Application::Application() : m_eventSystem(), m_inputSystem(), m_musicLibrary() {
+jade::Application::Application() : m_eventSystem(),
+m_player(Config::UseNullAudioDevice ? Player::Device::Null : Player::Device::Default),
+m_inputSystem(), m_musicLibrary(), m_threadPool() {
 	if (g_Application != nullptr) {
 		throw std::runtime_error("Application is already created");
 	}
@@ -18,6 +25,19 @@ jade::Application::Application() : m_eventSystem(), m_inputSystem(), m_musicLibr
 			new (m_backend) BackendConsole();
 			break;
 		}
+		case Config::Backend::SOCKET: {
+			m_backend = (BackendSocket*)::operator new(sizeof(BackendSocket));
+			new (m_backend) BackendSocket();
+			break;
+		}
+		case Config::Backend::BATCH: {
+			m_backend = (BackendBatch*)::operator new(sizeof(BackendBatch));
+			new (m_backend) BackendBatch();
+			break;
+		}
+	}
+	if (m_backend->ReadsKeyInput()) {
+		m_inputSystem.Enable();
 	}
 
 	m_eventSystem.Subscribe<OnApplicationClose>(0, [this](OnApplicationClose e) {
@@ -36,6 +56,15 @@ jade::Application::Application() : m_eventSystem(), m_inputSystem(), m_musicLibr
 
 jade::Application::~Application() {
 	if (m_backend != nullptr) {
+		// An unsaved close can leave tasks suspended on a hop to the main thread, their
+		// futures are waited on when the backend is destroyed
+		m_backend->CancelTasks();
+		while (m_backend->HasRunningTasks()) {
+			m_eventSystem.Dispatch();
+			if (m_backend->HasRunningTasks()) {
+				WaitForMainThreadWakeup(-1.0);
+			}
+		}
 		m_backend->~IBackend();
 		::operator delete (m_backend);
 		m_backend = nullptr;
@@ -54,11 +83,12 @@ const jade::Application& jade::Application::GetConst() {
 jade::Player& jade::Application::Player() { return g_Application->m_player; }
 const jade::Player& jade::Application::ConstPlayer() { return g_Application->m_player; }
 
-void jade::Application::MainLoop() {
+int jade::Application::MainLoop() {
 	if (m_states & State::StartedBit) {
-		return;
+		return m_exitCode;
 	}
 	m_states |= State::StartedBit;
+	JADE_TRACE_THREAD("Main");
 
 	auto startTimestamp = std::chrono::high_resolution_clock::now();
 
@@ -66,19 +96,52 @@ void jade::Application::MainLoop() {
 		auto frameTimestamp = std::chrono::high_resolution_clock::now();
 		Timestep deltaTime = std::chrono::duration<double>(frameTimestamp - startTimestamp).count();
 		startTimestamp = frameTimestamp;
-
-		m_backend->Render();
-
-		m_inputSystem.Update(deltaTime);
-		m_backend->Update(deltaTime);
-	
-		if (m_states & State::WaitForOthersBit) {
-			CloseRequest();
+		{
+			JADE_PROFILE_STAGE(ProfileStage::Frame);
+			{
+				JADE_PROFILE_STAGE(ProfileStage::Render);
+				m_backend->Render();
+			}
+			if (m_inputSystem.IsEnabled()) {
+				JADE_PROFILE_STAGE(ProfileStage::Input);
+				m_inputSystem.Update(deltaTime);
+			}
+			{
+				JADE_PROFILE_STAGE(ProfileStage::Backend);
+				m_backend->Update(deltaTime);
+			}
+			if (m_states & State::WaitForOthersBit) {
+				CloseRequest();
+			}
+			{
+				JADE_PROFILE_STAGE(ProfileStage::Timers);
+				m_eventSystem.Update(deltaTime);
+			}
+			{
+				JADE_PROFILE_STAGE(ProfileStage::Dispatch);
+				m_eventSystem.Dispatch();
+			}
 		}
-		m_eventSystem.Dispatch();
+		// A close dispatched this frame must not be followed by a wait nothing ends
+		if ((m_states & State::StartedBit) && !m_backend->HasPendingWork()) {
+			JADE_PROFILE_STAGE(ProfileStage::Wait);
+			WaitForMainThreadWakeup(_NextWakeupTimeout());
+		}
+	}
+	return m_exitCode;
+}
+
+jade::Timestep jade::Application::_NextWakeupTimeout() const noexcept {
+	Timestep timerTimeout  = m_eventSystem.GetTimeUntilNextTimer();
+	Timestep repeatTimeout = m_inputSystem.GetTimeUntilNextRepeat();
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	if (timerTimeout < 0.0) {
+		return repeatTimeout;
+	}
+	if (repeatTimeout < 0.0) {
+		return timerTimeout;
 	}
+	return timerTimeout < repeatTimeout ? timerTimeout : repeatTimeout;
 }
 
 void jade::Application::CloseRequest() {
@@ -3,6 +3,25 @@
 #include <miniaudio.h>
 #include <ma_reverb_node/ma_reverb_node.h>
 
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <algorithm>
+
+namespace {
+	// Frames of the MPEG stream, in the file's sample rate, that hold the actual track
+	struct GaplessInfo {
+		uint32_t sampleRate    = 0;
+		uint32_t frameSize     = 0;
+		uint64_t totalFrames   = 0; // every frame after the Info frame
+		uint64_t leadingFrames = 0; // encoder and decoder delay
+		uint64_t trackFrames   = 0;
+	};
+
+	std::optional<GaplessInfo> ReadGaplessInfo(const std::string& path);
+}
+
 struct jade::IAudioStream::_BaseImpl {
 public:
 	_BaseImpl() {
@@ -55,13 +74,20 @@ public:
 
 public:
 	bool Initialize(const std::string& path, double seconds, ma_node_graph* nodeGraph) {
-		ma_decoder newDecoder;
-		ma_result initResult = ma_decoder_init_file(path.c_str(), nullptr, &newDecoder);
+		Terminate();
+
+		ma_decoder_config config = ma_decoder_config_init(ma_format_f32, this->channelCount, this->sampleRate);
+		ma_result initResult = ma_decoder_init_file(path.c_str(), &config, &this->decoder);
 		if (initResult != ma_result::MA_SUCCESS) {
 			return false;
 		}
-		this->decoder = newDecoder;
-		this->duration = seconds;
+		this->duration   = seconds;
+		this->framesRead = 0;
+		this->endFrame   = UINT64_MAX;
+
+		if (std::optional<GaplessInfo> gapless = ReadGaplessInfo(path)) {
+			Trim(*gapless);
+		}
 
 		init_decoder_node(nodeGraph, &this->decoder, &this->decoderNode);
 		ma_node_attach_output_bus(
@@ -73,6 +99,29 @@ public:
 		return true;
 	}
 
+	// Starts the stream at the first track frame and ends it before the padding. The
+	// decoder may already trim them itself or emit the Info frame as silence, its
+	// length tells which.
+	void Trim(const GaplessInfo& gapless) {
+		ma_uint64 length = 0;
+		if (ma_decoder_get_length_in_pcm_frames(&this->decoder, &length) != MA_SUCCESS || length == 0) {
+			return;
+		}
+		double ratio = (double)this->decoder.outputSampleRate / gapless.sampleRate;
+		double sourceLength = (double)length / ratio;
+
+		auto distance = [sourceLength](uint64_t frames) { return std::abs(sourceLength - (double)frames); };
+		if (distance(gapless.trackFrames) < distance(gapless.totalFrames)) {
+			return;
+		}
+		uint64_t leadingFrames = gapless.leadingFrames;
+		if (distance(gapless.totalFrames + gapless.frameSize) < distance(gapless.totalFrames)) {
+			leadingFrames += gapless.frameSize;
+		}
+		ma_decoder_seek_to_pcm_frame(&this->decoder, (ma_uint64)std::llround((double)leadingFrames * ratio));
+		this->endFrame = (uint64_t)std::llround((double)gapless.trackFrames * ratio);
+	}
+
 	void Terminate() {
 		if (states & State::DecoderInitializedBit) {
 			ma_decoder_uninit(&decoder);
@@ -81,8 +130,11 @@ public:
 	}
 
 public:
+	uint32_t      channelCount = 0;
+	uint32_t      sampleRate   = 0;
 	uint64_t      states       = 0;
 	ma_uint64     framesRead   = 0;
+	ma_uint64     endFrame     = UINT64_MAX;
 	double        duration     = 0.0;
 	DecoderNode   decoderNode  = {};
 	ma_decoder    decoder      = {};
@@ -104,8 +156,10 @@ double jade::Audio::GetTrackLengthSeconds(const std::string& path) {
 	return seconds;
 }
 
-jade::AudioStream::AudioStream() {
+jade::AudioStream::AudioStream(uint32_t channelCount, uint32_t sampleRate) {
 	m_impl = std::make_unique<_Impl>();
+	m_impl->channelCount = channelCount;
+	m_impl->sampleRate   = sampleRate;
 	m_baseImpl = std::make_shared<_BaseImpl>();
 }
 
@@ -119,15 +173,13 @@ bool jade::AudioStream::Initialize(const std::string& path, double seconds) {
 	return m_impl->Initialize(path, seconds, &m_baseImpl->nodeGraph);
 }
 
-std::vector<float> jade::AudioStream::Read(size_t chunkSize) {
-	std::vector<float> buffer(chunkSize * m_impl->decoder.outputChannels);
-
+size_t jade::AudioStream::Read(std::span<float> out) {
+	ma_uint64 frameCount = std::min<ma_uint64>(out.size() / m_impl->decoder.outputChannels, m_impl->endFrame - m_impl->framesRead);
 	ma_uint64 framesRead = 0;
-	ma_decoder_read_pcm_frames(&m_impl->decoder, buffer.data(), chunkSize, &framesRead);
-	buffer.resize(framesRead * m_impl->decoder.outputChannels);
+	ma_decoder_read_pcm_frames(&m_impl->decoder, out.data(), frameCount, &framesRead);
 
 	m_impl->framesRead += framesRead;
-	return buffer;
+	return (size_t)framesRead;
 }
 
 size_t jade::AudioStream::GetSampleRate() const {
@@ -174,11 +226,56 @@ jade::AudioStreamSpeeded::~AudioStreamSpeeded() {
 }
 
 bool jade::AudioStreamSpeeded::Initialize(const std::string& audioPath, double seconds) {
+	m_position      = 0.0;
+	m_carriedFrames = 0;
 	return m_stream->Initialize(audioPath, seconds);
 }
 
-std::vector<float> jade::AudioStreamSpeeded::Read(size_t chunkSize) {
-	return m_stream->Read((size_t)(chunkSize * m_speed));
+size_t jade::AudioStreamSpeeded::Read(std::span<float> out) {
+	size_t channels   = GetChannelCount();
+	size_t frameCount = out.size() / channels;
+	if (frameCount == 0) {
+		return 0;
+	}
+	// Nothing left over to interpolate from, the wrapped stream can write in place
+	if (m_speed == 1.0 && m_carriedFrames == 0 && m_position == 0.0) {
+		return m_stream->Read(out);
+	}
+	// Output frame j interpolates between scratch frames floor(p) and floor(p) + 1
+	// with p = m_position + j * m_speed
+	size_t totalFrames  = (size_t)(m_position + (double)(frameCount - 1) * m_speed) + 2;
+	size_t sourceFrames = totalFrames > m_carriedFrames ? totalFrames - m_carriedFrames : 0;
+	if (m_scratch.size() < totalFrames * channels) {
+		m_scratch.resize(totalFrames * channels);
+	}
+	size_t available = m_carriedFrames + m_stream->Read(
+		std::span<float>(m_scratch.data() + m_carriedFrames * channels, sourceFrames * channels)
+	);
+
+	size_t frame = 0;
+	for (; frame < frameCount; ++frame) {
+		double position = m_position + (double)frame * m_speed;
+		size_t index    = (size_t)position;
+		if (index + 1 >= available) {
+			break;
+		}
+		float weight = (float)(position - (double)index);
+		const float* left  = m_scratch.data() + index * channels;
+		const float* right = left + channels;
+
+		for (size_t channel = 0; channel < channels; ++channel) {
+			out[frame * channels + channel] = left[channel] + (right[channel] - left[channel]) * weight;
+		}
+	}
+	// Frames the next output still interpolates from move to the front of the scratch
+	double position = m_position + (double)frameCount * m_speed;
+	size_t first    = std::min((size_t)position, available);
+
+	std::copy(m_scratch.begin() + first * channels, m_scratch.begin() + available * channels, m_scratch.begin());
+	m_carriedFrames = available - first;
+	m_position      = position - (double)first;
+
+	return frame;
 }
 
 size_t jade::AudioStreamSpeeded::GetSampleRate() const {
@@ -201,4 +298,75 @@ std::shared_ptr<jade::IAudioStream> jade::SetSpeed(std::shared_ptr<IAudioStream>
 		currStream = effect->GetStream();
 	}
 	return std::make_shared<AudioStreamSpeeded>(stream, speed);
+}
+
+namespace {
+	uint32_t ReadBigEndian32(const uint8_t* bytes) {
+		return (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | bytes[3];
+	}
+
+	// Reads the Xing/Info header of the first MPEG Layer III frame and the LAME
+	// extension that follows it, if any
+	std::optional<GaplessInfo> ReadGaplessInfo(const std::string& path) {
+		std::ifstream file(path, std::ios::binary);
+
+		uint8_t id3[10] = {};
+		if (!file.read((char*)id3, sizeof(id3))) {
+			return std::nullopt;
+		}
+		std::streamoff offset = 0;
+		if (std::memcmp(id3, "ID3", 3) == 0) {
+			offset = 10 + ((id3[6] & 0x7F) << 21 | (id3[7] & 0x7F) << 14 | (id3[8] & 0x7F) << 7 | (id3[9] & 0x7F));
+			if (id3[5] & 0x10) {
+				offset += 10; // footer
+			}
+		}
+		// Header, side information and the longest Xing header with a LAME extension
+		uint8_t frame[4 + 32 + 120 + 24] = {};
+		if (!file.seekg(offset) || !file.read((char*)frame, sizeof(frame))) {
+			return std::nullopt;
+		}
+		if (frame[0] != 0xFF || (frame[1] & 0xE0) != 0xE0) {
+			return std::nullopt;
+		}
+		uint8_t version   = (frame[1] >> 3) & 0x3; // 3 is MPEG 1, 2 is MPEG 2, 0 is MPEG 2.5
+		uint8_t layer     = (frame[1] >> 1) & 0x3; // 1 is Layer III
+		uint8_t rateIndex = (frame[2] >> 2) & 0x3;
+		bool    isMono    = (frame[3] >> 6) == 0x3;
+		if (version == 1 || layer != 1 || rateIndex == 3) {
+			return std::nullopt;
+		}
+		static constexpr uint32_t s_SampleRates[] = { 44100, 48000, 32000 };
+		bool isMpeg1 = version == 3;
+
+		GaplessInfo info;
+		info.sampleRate = s_SampleRates[rateIndex] >> (isMpeg1 ? 0 : version == 2 ? 1 : 2);
+		info.frameSize  = isMpeg1 ? 1152 : 576;
+
+		size_t cursor = 4 + (isMpeg1 ? (isMono ? 17 : 32) : (isMono ? 9 : 17));
+		if (std::memcmp(frame + cursor, "Xing", 4) != 0 && std::memcmp(frame + cursor, "Info", 4) != 0) {
+			return std::nullopt;
+		}
+		uint32_t flags = ReadBigEndian32(frame + cursor + 4);
+		if (!(flags & 0x1)) {
+			return std::nullopt;
+		}
+		info.totalFrames = (uint64_t)ReadBigEndian32(frame + cursor + 8) * info.frameSize;
+		info.trackFrames = info.totalFrames;
+		cursor += 12 + (flags & 0x2 ? 4 : 0) + (flags & 0x4 ? 100 : 0) + (flags & 0x8 ? 4 : 0);
+
+		// Delay and padding are two 12 bit fields after the 21 bytes of encoder version,
+		// quality and gain. Decoders add 529 frames of delay that the padding covers.
+		const uint8_t* lame = frame + cursor;
+		if (std::memcmp(lame, "LAME", 4) == 0 || std::memcmp(lame, "Lavc", 4) == 0 || std::memcmp(lame, "Lavf", 4) == 0) {
+			uint64_t delay   = (uint64_t)lame[21] << 4 | lame[22] >> 4;
+			uint64_t padding = (uint64_t)(lame[22] & 0x0F) << 8 | lame[23];
+
+			if (delay + padding < info.totalFrames) {
+				info.leadingFrames = delay + 529;
+				info.trackFrames   = info.totalFrames - delay - padding;
+			}
+		}
+		return info;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include <jade/backend/BackendBatch.h>
+#include <jade/App.h>
+#include <jade/Platform.h>
+
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+#if !defined(_WIN32) && !defined(WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+jade::BackendBatch::BackendBatch(const std::filesystem::path& script) {
+	if (script.empty()) {
+	#if !defined(_WIN32) && !defined(WIN32)
+		// The input system made stdin non-blocking, the script is read with blocking reads
+		fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) & ~O_NONBLOCK);
+	#endif
+		m_input = &std::cin;
+	}
+	else {
+		m_file.open(script);
+		if (!m_file.is_open()) {
+			throw std::runtime_error("Failed to open batch script '" + script.string() + "'");
+		}
+		m_input = &m_file;
+	}
+	// The next line is only read once the running command is done, so stdin becoming
+	// readable must not wake the main loop
+	SetConsoleInputClosed();
+	m_batchStart = Clock::now();
+}
+
+void jade::BackendBatch::Update(Timestep) {
+	if (m_states & State::ShouldTerminateBit) {
+		if (m_tasks.GetActiveCount() == 0) m_states &= ~State::ShouldTerminateBit;
+		return;
+	}
+	_UpdateLibraryView();
+
+	if (m_hasCommand) {
+		if (_IsCommandRunning()) {
+			return;
+		}
+		_FinishCommand();
+	}
+	if (m_isFinished) {
+		return;
+	}
+	// One command per update, events it caused are dispatched before the next one runs
+	std::string line;
+	while (std::getline(*m_input, line)) {
+		++m_lineNumber;
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+		size_t start = line.find_first_not_of(" \t");
+		if (start == std::string::npos || line[start] == '#') {
+			continue;
+		}
+		m_command          = std::move(line);
+		m_hasCommand       = true;
+		m_errorCountBefore = m_errorCount;
+		m_commandStart     = Clock::now();
+
+		m_isCommandExecuted = ExecuteCommand(m_command);
+		if (!_IsCommandRunning()) {
+			_FinishCommand();
+		}
+		return;
+	}
+	_Finish();
+}
+
+void jade::BackendBatch::Render() {
+	std::cout.flush();
+}
+
+bool jade::BackendBatch::HasPendingWork() const {
+	if (m_states & State::ShouldTerminateBit) {
+		return m_tasks.GetActiveCount() == 0;
+	}
+	if (m_isFinished) {
+		return false;
+	}
+	return (m_states & State::LibraryViewPendingBit) || !_IsCommandRunning();
+}
+
+std::ostream& jade::BackendBatch::Out() {
+	return std::cout;
+}
+
+bool jade::BackendBatch::_IsCommandRunning() const noexcept {
+	return m_hasCommand && (m_tasks.GetActiveCount() > 0 || (m_states & State::LibraryViewPendingBit));
+}
+
+void jade::BackendBatch::_FinishCommand() {
+	double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - m_commandStart).count();
+	bool isFailed = !m_isCommandExecuted || m_errorCount != m_errorCountBefore;
+
+	++m_commandCount;
+	if (isFailed) {
+		++m_failedCount;
+		Application::Get().SetExitCode(1);
+	}
+	// Output of the command comes before its timing when both go to a terminal
+	std::cout.flush();
+	std::cerr << (isFailed ? "FAIL" : "ok") << '\t' << std::fixed << std::setprecision(3)
+		<< milliseconds << " ms\t" << m_lineNumber << ": " << m_command << '\n';
+
+	m_hasCommand = false;
+}
+
+void jade::BackendBatch::_Finish() {
+	m_isFinished = true;
+	if (m_input->bad()) {
+		ShowError("Failed to read the batch script");
+		Application::Get().SetExitCode(1);
+	}
+	double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - m_batchStart).count();
+
+	std::cout.flush();
+	std::cerr << m_commandCount << " commands, " << m_failedCount << " failed, "
+		<< std::fixed << std::setprecision(3) << milliseconds << " ms total\n";
+
+	Application::Get().CloseRequest();
+}
\ No newline at end of file
@@ -1,41 +1,21 @@
 #include <jade/backend/BackendConsole.h>
 #include <jade/Platform.h>
-#include <jade/App.h>
+#include <jade/InputSystem.h>
+#include <jade/Trace.h>
 
-#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
 
 namespace {
-	void ClearConsoleLine() { std::cout << "\33[2K\r"; }
-	jade::BackendConsole::Command GetCommandFromName(const std::string&);
-	std::vector<std::vector<std::string>> Tokenize(const std::string&);
-
-	void PlaylistCreateExecute(std::vector<std::vector<std::string>>& tokens);
-}
-
-namespace {
-	const std::map<std::string, jade::BackendConsole::Command> g_CommandMap = {
-		{ "close",		     jade::BackendConsole::Command::Close },
-		{ "close_unsaved",   jade::BackendConsole::Command::CloseUnsaved },
-
-		{ "lib_add",         jade::BackendConsole::Command::LibraryAdd },
-		{ "lib_save",        jade::BackendConsole::Command::LibrarySave },
-		{ "lib_show",        jade::BackendConsole::Command::LibraryShow },
-
-		{ "play",            jade::BackendConsole::Command::Play },
-		{ "pause",           jade::BackendConsole::Command::Pause },
-		{ "resume",          jade::BackendConsole::Command::Resume },
-		{ "volume",          jade::BackendConsole::Command::Volume },
-		{ "speed",			 jade::BackendConsole::Command::Speed },
-
-		{ "playlist_create", jade::BackendConsole::Command::PlaylistCreate }
-	};
+	bool IsSeparator(char c) noexcept;
 }
 
 jade::BackendConsole::BackendConsole() {
-	for (size_t i = 0; i < (size_t)TaskType::AsyncCancellableCount; ++i) {
-		m_futureTasks[i] = std::make_shared<FutureTask>();
+	for (const auto& [name, spec] : GetCommands()) {
+		m_commandNames.Insert(name);
 	}
-	m_musicLibrary.SetMusicLibrary(&MusicLibrary::Get());
+	m_historyPosition = m_history.Size();
 
 	EventSystem::Get().Subscribe<OnKeyAction>(50, [this](const OnKeyAction& e) {
 		m_taskQueue.emplace(Task{
@@ -44,119 +24,64 @@ jade::BackendConsole::BackendConsole() {
 			.payload  = Task::Payload(e)
 		});
 	});
-	EventSystem::Get().Subscribe<OnTaskEnded>(50, [this](const OnTaskEnded& e) {
-		if (e.status == OnTaskEnded::Status::Failed) {
-			ShowError(e.errorMsg);
-			return;
-		}
-		if (e.status == OnTaskEnded::Status::Success) {
-			DispatchTaskResult(e);
-			return;
-		}
-	});
-	EventSystem::Get().Subscribe<OnAsyncTaskEnded>(50, [this](OnAsyncTaskEnded& e) {
-		--m_workingTaskCount;
-		if (e.task) {
-			e.task->Wait();
-		}
-		if (e.status == OnTaskEnded::Status::Failed) {
-			ShowError(e.errorMsg);
-			return;
-		}
-		if (e.status == OnTaskEnded::Status::Success) {
-			DispatchTaskResult(e);
-			return;
-		}
-	});
-	EventSystem::Get().Subscribe<OnApplicationClose>(50, [this](OnApplicationClose& e) {
-		if (m_workingTaskCount > 0) {
-			if (!(m_states & State::AllTasksCancelledBit)) {
-				for (auto& task : m_futureTasks) {
-					task->Cancel();
-				}
-				m_states |= State::AllTasksCancelledBit;
-			}
-			e.closeState = e.WaitForOthers;
-			m_states |= State::ShouldTerminateBit;
-		}
-	});
 }
 
 void jade::BackendConsole::Update(Timestep deltaTime) {
 	if (m_states & State::ShouldTerminateBit) {
-		if (m_workingTaskCount == 0) m_states &= ~State::ShouldTerminateBit;
+		if (m_tasks.GetActiveCount() == 0) m_states &= ~State::ShouldTerminateBit;
 		return;
 	}
 	while (!m_taskQueue.empty()) {
 		DispatchTask(m_taskQueue.front());
 		m_taskQueue.pop();
 	}
-}
-
-void jade::BackendConsole::Render() {
-	if (m_states & State::ShouldShowNewInputBit) {
-		ShowNewInput();
-		m_states &= ~State::ShouldShowNewInputBit;
+	_UpdateLibraryView();
+	if (m_states & ConsoleState::ReverseSearchBit) {
+		std::string_view match = m_searchMatch != CommandHistory::s_NotFound ? m_history.Get(m_searchMatch) : std::string_view();
+		size_t matchPosition = match.find(m_searchQuery);
+
+		m_searchPrompt.assign(m_searchMatch != CommandHistory::s_NotFound || m_searchQuery.empty()
+			? "(reverse-i-search)'" : "(failed reverse-i-search)'");
+		m_searchPrompt.append(m_searchQuery).append("': ");
+		m_renderer.SetInputLine(m_searchPrompt, match, matchPosition == std::string_view::npos ? 0 : matchPosition);
+	}
+	else {
+		m_renderer.SetInputLine(s_Prompt, m_commandBuffer, m_cursorPosition);
 	}
 }
 
-void jade::BackendConsole::ShowNewInput() const {
-	std::cout << "<Jade> ";
-}
-
-size_t jade::BackendConsole::ShowNewInputCharSize() const noexcept {
-	return sizeof("<Jade> ") - 1;
+void jade::BackendConsole::Render() {
+	m_renderer.Present();
 }
 
-void jade::BackendConsole::ShowError(const std::string& error) const {
-	ClearConsoleLine();
-	std::cout << "Error: " << error << '\n';
-	ShowNewInput();
-	std::cout << m_commandBuffer;
+bool jade::BackendConsole::HasPendingWork() const {
+	if (m_states & State::ShouldTerminateBit) {
+		return m_tasks.GetActiveCount() == 0;
+	}
+	return !m_taskQueue.empty() || (m_states & State::LibraryViewPendingBit) || m_renderer.IsDirty();
 }
 
 void jade::BackendConsole::DispatchTask(const Task& task) {
+	JADE_TRACE_SCOPE("BackendConsole::DispatchTask");
 	((*this).*m_dispatchTaskTable[(size_t)task.type])(task);
 }
 
-void jade::BackendConsole::DispatchTaskResult(const OnTaskEnded& endedTask) const {
-	ClearConsoleLine();
-
-	ShowNewInput();
-	std::cout << m_commandBuffer;
-}
-
-void jade::BackendConsole::DispatchTaskResult(const OnAsyncTaskEnded& endedTask) const {
-	ClearConsoleLine();
-
-	switch (endedTask.whatTask) {
-		case TaskType::AsyncMusicLibrarySave:
-			std::cout << "Music library changes have been successfully saved\n";
-			break;
-
-		case TaskType::AsyncMusicLibraryAdd:
-			std::cout << "Track has been successfully added to music library\n";
-			break;
-	}
-	ShowNewInput();
-	std::cout << m_commandBuffer;
-}
-
 void jade::BackendConsole::KeyActionTask(const Task& task) {
 	const OnKeyAction& keyAction = std::get<OnKeyAction>(task.payload);
 
 	if (keyAction.pressed) {
+		if (m_states & ConsoleState::ReverseSearchBit) {
+			_ReverseSearchKey(keyAction);
+			return;
+		}
+		if (keyAction.key == Key::R && (bool)(keyAction.mods & KeyModifier::Ctrl)) {
+			_BeginReverseSearch();
+			return;
+		}
 		if (keyAction.key == Key::V && (bool)(keyAction.mods & KeyModifier::LCtrl)) {
 			std::string clipboardText = GetClipboardTextContent();
 			m_commandBuffer.insert(m_cursorPosition, clipboardText);
-
-			RerenderCommandLineTask(Task{
-				.type     = Task::Type::RerenderCommandLine,
-				.category = TaskCategory::Sync,
-				.payload  = Task::RerenderCommandLine{
-					.prevSize = m_commandBuffer.size() - clipboardText.size()
-				}
-			});
+			m_cursorPosition += clipboardText.size();
 			return;
 		}
 
@@ -165,55 +90,47 @@ void jade::BackendConsole::KeyActionTask(const Task& task) {
 			if (m_cursorPosition > m_commandBuffer.size()) {
 				m_cursorPosition = m_commandBuffer.size();
 			}
-			m_commandBuffer.insert(m_cursorPosition, 1, keyChar);
-
-			RerenderCommandLineTask(Task{
-				.type = Task::Type::RerenderCommandLine,
-				.category = TaskCategory::Sync,
-				.payload = Task::RerenderCommandLine{
-					.prevSize = m_commandBuffer.size() - 1
-				}
-			});
+			m_commandBuffer.insert(m_cursorPosition, keyAction.repeat, keyChar);
+			m_cursorPosition += keyAction.repeat;
 			return;
 		}
 
 		switch (keyAction.key) {
 			case Key::Backspace:
 				if (!m_commandBuffer.empty() && m_cursorPosition > 0) {
-					m_commandBuffer.erase(m_cursorPosition - 1, 1);
-
-					RerenderCommandLineTask(Task{
-						.type = Task::Type::RerenderCommandLine,
-						.category = TaskCategory::Sync,
-						.payload = Task::RerenderCommandLine{
-							.prevSize = m_commandBuffer.size() + 1
-						}
-					});
+					size_t eraseCount = std::min<size_t>(keyAction.repeat, m_cursorPosition);
+					m_commandBuffer.erase(m_cursorPosition - eraseCount, eraseCount);
+					m_cursorPosition -= eraseCount;
 				}
 				break;
 
+			case Key::Tab:
+				_CompleteInput();
+				break;
+
 			case Key::Enter:
-				m_taskQueue.emplace(Task{
-					.type = Task::Type::Execute,
-					.category = TaskCategory::Sync,
-					.payload = Task::Payload(Task::ExecuteCmd{
-						.cmd = std::move(m_commandBuffer)
-					})
-				});
-				m_commandBuffer.clear();
+				_SubmitInput();
+				break;
+
+			case Key::Up:
+				_BrowseHistory(true, keyAction.repeat);
+				break;
+
+			case Key::Down:
+				_BrowseHistory(false, keyAction.repeat);
 				break;
 
 			case Key::Left:
 				if (m_cursorPosition > 0) {
-					--m_cursorPosition;
-					std::cout << '\b';
+					size_t moveCount = std::min<size_t>(keyAction.repeat, m_cursorPosition);
+					m_cursorPosition -= moveCount;
 				}
 				break;
 
 			case Key::Right:
 				if (m_cursorPosition < m_commandBuffer.size()) {
-					++m_cursorPosition;
-					std::cout << "\033[1C";
+					size_t moveCount = std::min<size_t>(keyAction.repeat, m_commandBuffer.size() - m_cursorPosition);
+					m_cursorPosition += moveCount;
 				}
 				break;
 		}
@@ -221,254 +138,262 @@ void jade::BackendConsole::KeyActionTask(const Task& task) {
 }
 
 void jade::BackendConsole::ExecuteCmdTask(const Task& task) {
-	std::cout << '\n';
-	DispatchCmdExecution(task);
+	// The entered line stays in the log above the new input line
+	m_renderer.Out() << s_Prompt << std::get<Task::ExecuteCmd>(task.payload).cmd << '\n';
+	ExecuteCommand(std::get<Task::ExecuteCmd>(task.payload).cmd);
 }
 
-void jade::BackendConsole::RerenderCommandLineTask(const Task& task) {
-	Task::RerenderCommandLine rerenderInfo = std::get<Task::RerenderCommandLine>(task.payload);
-
-	if (m_commandBuffer.size() > rerenderInfo.prevSize) {
-		size_t insertedSize = m_commandBuffer.size() - rerenderInfo.prevSize;
+void jade::BackendConsole::_CompleteInput() {
+	std::string_view line(m_commandBuffer.data(), std::min(m_cursorPosition, m_commandBuffer.size()));
 
-		std::cout << m_commandBuffer.data() + m_cursorPosition;
-		m_cursorPosition += insertedSize;
+	size_t commandStart = line.find_first_not_of(" \t");
+	if (commandStart == std::string_view::npos) {
+		commandStart = line.size();
 	}
-	else {
-		size_t removedCount = rerenderInfo.prevSize - m_commandBuffer.size();
-
-		std::cout << "\033[" << removedCount << 'D';
-		std::cout << m_commandBuffer.data() + (m_cursorPosition - removedCount) << "\033[K";
-		m_cursorPosition -= removedCount;
-	}
-	std::cout << "\r\033[" << ShowNewInputCharSize() + m_cursorPosition << 'C';
-}
-
-void jade::BackendConsole::DispatchCmdExecution(const Task& task) {
-	const std::string& cmd = std::get<Task::ExecuteCmd>(task.payload).cmd;
-	if (cmd.empty()) {
+	size_t commandEnd = line.find_first_of(" \t", commandStart);
+	if (commandEnd == std::string_view::npos) {
+		_ApplyCompletion(commandStart, m_commandNames.Complete(line.substr(commandStart), s_MaxCompletionCandidates), " ");
 		return;
 	}
-	std::vector<std::vector<std::string>> tokens = Tokenize(cmd);
-	if (!tokens.back().empty()) {
-		ShowError(tokens.back().front());
+	auto command = GetCommands().find(line.substr(commandStart, commandEnd - commandStart));
+	if (command == GetCommands().cend()) {
 		return;
 	}
-	tokens.pop_back();
-	Command command = GetCommandFromName(tokens.front().front());
+	size_t segmentStart = line.find_last_of(';');
+	segmentStart = segmentStart == std::string_view::npos || segmentStart < commandEnd ? commandEnd : segmentStart + 1;
+
+	size_t colon = line.find(':', segmentStart);
+	if (colon == std::string_view::npos) {
+		// Parameter pack names come from the command's schema, which is tiny
+		size_t wordStart = line.find_first_not_of(" \t", segmentStart);
+		if (wordStart == std::string_view::npos) {
+			wordStart = line.size();
+		}
+		std::string_view word = line.substr(wordStart);
 
-	if (command == Command::None) {
-		std::cout << "Unknown command '" << tokens.front().front() << "'\n";
-		m_states |= State::ShouldShowNewInputBit;
+		RadixTree packNames;
+		for (const CommandParser::Param& param : command->second.params) {
+			if (param.name.starts_with(word)) {
+				packNames.Insert(param.name);
+			}
+		}
+		_ApplyCompletion(wordStart, packNames.Complete(word, s_MaxCompletionCandidates), " ");
 		return;
 	}
-	((*this).*m_dispatchCmdTable[(size_t)command])(tokens);
-}
-
-void jade::BackendConsole::ExecuteCloseCmd(std::vector<std::vector<std::string>>& tokens) {
-	jade::Application::Get().CloseRequest();
-}
-
-void jade::BackendConsole::ExecuteCloseUnsavedCmd(std::vector<std::vector<std::string>>& tokens) {
-	jade::Application::Get().CloseUnsavedRequest();
-}
-
-void jade::BackendConsole::ExecuteLibraryShowCmd(std::vector<std::vector<std::string>>& tokens) {
-	auto trackIt    = m_musicLibrary.TrackIteratorBegin();
-	auto trackItEnd = m_musicLibrary.TrackIteratorEnd();
+	std::string_view pack = line.substr(segmentStart, colon + 1 - segmentStart);
+	pack.remove_prefix(std::min(pack.find_first_not_of(" \t"), pack.size()));
 
-	if (trackIt == trackItEnd) {
-		std::cout << "Music library is empty\n";
-		m_states |= State::ShouldShowNewInputBit;
+	auto param = std::find_if(command->second.params.begin(), command->second.params.end(),
+		[pack](const CommandParser::Param& param) { return param.name == pack; });
+	if (param == command->second.params.end()) {
 		return;
 	}
 
-	for (; trackIt != trackItEnd; ++trackIt) {
-		std::cout << "\t- ID " << trackIt->second.id << ": ";
-		for (size_t i = 0; i < trackIt->second.artists.size(); ++i) {
-			std::cout << trackIt->second.artists[i];
-			if (i + 1 < trackIt->second.artists.size()) {
-				std::cout << ", ";
-			}
-		}
-		std::cout << " - " << trackIt->second.name;
-		if (!trackIt->second.feat.empty()) {
-			std::cout << " (feat ";
-			for (size_t i = 0; i < trackIt->second.feat.size(); ++i) {
-				std::cout << trackIt->second.feat[i];
-				if (i + 1 < trackIt->second.feat.size()) {
-					std::cout << ", ";
-				}
-			}
-			std::cout << ')';
-		}
-		std::cout << '\n';
-	}
-	m_states |= State::ShouldShowNewInputBit;
-}
-
-void jade::BackendConsole::ExecuteLibrarySaveCmd(std::vector<std::vector<std::string>>& tokens) {
-	++m_workingTaskCount;
-	m_musicLibrary.SaveChanges();
-}
+	size_t valueStart = line.find_last_of(',');
+	valueStart = valueStart == std::string_view::npos || valueStart < colon ? colon + 1 : valueStart + 1;
+	valueStart = std::min(line.find_first_not_of(" \t", valueStart), line.size());
+	std::string_view value = line.substr(valueStart);
 
-void jade::BackendConsole::ExecuteLibraryAddCmd(std::vector<std::vector<std::string>>& tokens) {
-	std::vector<std::string> artists;
-	std::vector<std::string> feat;
-	std::string name;
-	std::string path;
-
-	for (size_t i = 1; i < tokens.size(); ++i) {
-		std::vector<std::string>& pack = tokens[i];
-		if (std::strcmp("artists:", pack.front().c_str()) == 0) {
-			for (size_t i = 1; i < pack.size(); ++i) {
-				artists.emplace_back(std::move(pack[i]));
-			}
+	switch (param->source) {
+		case CommandParser::ValueSource::None: {
+			return;
 		}
-		else if (std::strcmp("feat:", pack.front().c_str()) == 0) {
-			for (size_t i = 1; i < pack.size(); ++i) {
-				feat.emplace_back(std::move(pack[i]));
-			}
+		case CommandParser::ValueSource::Path: {
+			_CompletePath(valueStart);
+			return;
 		}
-		else if (std::strcmp("name:", pack.front().c_str()) == 0) {
-			name = std::move(pack[1]);
+		case CommandParser::ValueSource::ArtistName: {
+			_ApplyCompletion(valueStart, m_musicLibrary.CompleteName(
+				MusicLibrary::NameIndex::Artists, value, s_MaxCompletionCandidates), "");
+			return;
 		}
-		else if (std::strcmp("path:", pack.front().c_str()) == 0) {
-			path = std::move(pack[1]);
+		case CommandParser::ValueSource::TrackName: {
+			_ApplyCompletion(valueStart, m_musicLibrary.CompleteName(
+				MusicLibrary::NameIndex::Tracks, value, s_MaxCompletionCandidates), "");
+			return;
 		}
-		else {
-			ShowError(std::string("Unknown parameter pack '") + pack.front() + '\'');
+		case CommandParser::ValueSource::TrackID: {
+			_CompleteTrackID(valueStart, value);
 			return;
 		}
 	}
-	std::shared_ptr<jade::FutureTask>& currFutureTask = m_futureTasks[(size_t)jade::TaskType::AsyncMusicLibraryAdd];
-
-	currFutureTask->Wait();
-	++m_workingTaskCount;
-	currFutureTask->SetTask(m_musicLibrary.Add(artists, feat, name, path, currFutureTask));
 }
 
-void jade::BackendConsole::ExecutePlayCmd(std::vector<std::vector<std::string>>& tokens) {
-	uint64_t id = std::atoi(tokens[1][1].c_str());
-	MusicLibrary::TrackIterator track = m_musicLibrary.GetTrackByID(id);
-
-	if (track == m_musicLibrary.TrackIteratorEnd()) {
-		std::cout << "No track found with ID = " << id << '\n';
+void jade::BackendConsole::_CompleteTrackID(size_t valueStart, std::string_view value) {
+	// A track name typed as the value is replaced with the track's ID once it is unique
+	if (value.empty() || value.find_first_not_of("0123456789") == std::string_view::npos) {
+		return;
 	}
-	else {
-		Application::Get().Player().Play(track->second);
+	RadixTree::Completion completion = m_musicLibrary.CompleteName(
+		MusicLibrary::NameIndex::Tracks, value, s_MaxCompletionCandidates);
+
+	if (completion.matchCount == 1 && completion.candidates.size() == 1) {
+		std::string id = std::to_string(completion.candidates.front().value);
+		m_commandBuffer.replace(valueStart, m_cursorPosition - valueStart, id);
+		m_cursorPosition = valueStart + id.size();
+		return;
 	}
-	m_states |= State::ShouldShowNewInputBit;
+	_ApplyCompletion(valueStart, completion, "", true);
 }
 
-void jade::BackendConsole::ExecutePauseCmd(std::vector<std::vector<std::string>>& tokens) {
-	Application::Get().Player().Pause();
-	m_states |= State::ShouldShowNewInputBit;
-}
+void jade::BackendConsole::_CompletePath(size_t wordStart) {
+	std::string_view word(m_commandBuffer.data() + wordStart, m_cursorPosition - wordStart);
 
-void jade::BackendConsole::ExecuteResumeCmd(std::vector<std::vector<std::string>>& tokens) {
-	Application::Get().Player().Resume();
-	m_states |= State::ShouldShowNewInputBit;
-}
+	size_t separator = word.size();
+	while (separator > 0 && !IsSeparator(word[separator - 1])) --separator;
+
+	std::string_view directoryPart = word.substr(0, separator);
+	std::string_view filePart      = word.substr(separator);
+	std::filesystem::path directory = directoryPart.empty() ? std::filesystem::path(".") : std::filesystem::path(directoryPart);
 
-void jade::BackendConsole::ExecuteVolumeCmd(std::vector<std::vector<std::string>>& tokens) {
-	if (strcmp("%:", tokens[1][1].c_str())) {
-		float volume;
-		try {
-			volume = std::stof(tokens[1][1]);
+	RadixTree entries;
+	std::error_code error;
+	for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+		std::string name = it->path().filename().string();
+		if (!name.starts_with(filePart)) {
+			continue;
 		}
-		catch (const std::invalid_argument&) {
-			std::cout << "Invalid percentage number format\n";
-			m_states |= State::ShouldShowNewInputBit;
-			return;
+		if (it->is_directory(error)) {
+			name += '/';
 		}
-		Application::Get().Player().SetVolume(volume * 0.01f);
-
-		std::cout << "Player sound volume has been set to " << volume << "%\n";
-		m_states |= State::ShouldShowNewInputBit;
+		entries.Insert(name);
 	}
+	_ApplyCompletion(wordStart + separator, entries.Complete(filePart, s_MaxCompletionCandidates), "");
 }
 
-void jade::BackendConsole::ExecuteSpeedCmd(std::vector<std::vector<std::string>>& tokens) {
-	if (strcmp("x:", tokens[1][1].c_str())) {
-		double speed;
-		try {
-			speed = std::stod(tokens[1][1]);
+void jade::BackendConsole::_ApplyCompletion(size_t wordStart, const RadixTree::Completion& completion,
+std::string_view uniqueSuffix, bool showValues) {
+	if (completion.matchCount == 0) {
+		return;
+	}
+	size_t wordSize = m_cursorPosition - wordStart;
+
+	if (completion.completed.size() > wordSize || completion.matchCount == 1) {
+		std::string text = completion.completed;
+		if (completion.matchCount == 1) {
+			text += uniqueSuffix;
 		}
-		catch (const std::invalid_argument&) {
-			std::cout << "Invalid number format\n";
-			m_states |= State::ShouldShowNewInputBit;
-			return;
+		m_commandBuffer.replace(wordStart, wordSize, text);
+		m_cursorPosition = wordStart + text.size();
+		return;
+	}
+	for (const RadixTree::Candidate& candidate : completion.candidates) {
+		m_renderer.Out() << '\t' << candidate.key;
+		if (showValues) {
+			m_renderer.Out() << " (ID " << candidate.value << ')';
 		}
-		Application::Get().Player().SetSpeed(speed);
-
-		std::cout << "Player speed has been set to " << speed << "\n";
-		m_states |= State::ShouldShowNewInputBit;
+		m_renderer.Out() << '\n';
+	}
+	if (completion.matchCount > completion.candidates.size()) {
+		m_renderer.Out() << "\t... and " << completion.matchCount - completion.candidates.size() << " more\n";
 	}
 }
 
-namespace {
-	jade::BackendConsole::Command GetCommandFromName(const std::string& name) {
-		auto it = g_CommandMap.find(name);
-		if (it == g_CommandMap.cend()) {
-			return jade::BackendConsole::Command::None;
-		}
-		return it->second;
-	}
+void jade::BackendConsole::_SubmitInput() {
+	m_history.Append(m_commandBuffer);
+	m_historyPosition = m_history.Size();
 
-	std::vector<std::vector<std::string>> Tokenize(const std::string& str) {
-		std::vector<std::vector<std::string>> tokens;
+	m_taskQueue.emplace(Task{
+		.type = Task::Type::Execute,
+		.category = TaskCategory::Sync,
+		.payload = Task::Payload(Task::ExecuteCmd{
+			.cmd = std::move(m_commandBuffer)
+		})
+	});
+	m_commandBuffer.clear();
+	m_cursorPosition = 0;
+}
 
-		size_t i = 0;
-		size_t len = str.length();
+void jade::BackendConsole::_BrowseHistory(bool older, size_t steps) {
+	size_t size = m_history.Size();
+	size_t position = older ? m_historyPosition - std::min(steps, m_historyPosition)
+		: std::min(m_historyPosition + steps, size);
 
-		while (i < len && std::isspace(str[i])) { ++i; }
-		{
-			std::string commandToken;
-			while (i < len && !std::isspace(str[i])) {
-				commandToken += str[i++];
-			}
-			tokens.emplace_back();
-			tokens.back().emplace_back(std::move(commandToken));
-		}
+	if (position == m_historyPosition) {
+		return;
+	}
+	// The line being edited comes back when browsing past the newest entry
+	if (m_historyPosition == size) {
+		m_editedInput = m_commandBuffer;
+	}
+	m_historyPosition = position;
+	m_commandBuffer   = position == size ? m_editedInput : std::string(m_history.Get(position));
+	m_cursorPosition  = m_commandBuffer.size();
+}
 
-		while (i < len) {
-			while (i < len && std::isspace(str[i])) { ++i; }
+void jade::BackendConsole::_BeginReverseSearch() {
+	m_editedInput = m_commandBuffer;
+	m_searchQuery.clear();
+	m_searchMatch = CommandHistory::s_NotFound;
+	m_states |= ConsoleState::ReverseSearchBit;
+}
 
-			std::string token;
-			while (i < len && !std::isspace(str[i])) {
-				token += str[i++];
-			}
-			if (token.back() != ':' && tokens.back().front().back() != ':') {
-				tokens.emplace_back();
-				tokens.back().emplace_back("Parameter pack name was not specified");
-				return tokens;
+void jade::BackendConsole::_ReverseSearchKey(const OnKeyAction& keyAction) {
+	if (keyAction.key == Key::R && (bool)(keyAction.mods & KeyModifier::Ctrl)) {
+		if (m_searchMatch != CommandHistory::s_NotFound) {
+			size_t older = m_history.FindOlder(m_searchQuery, m_searchMatch);
+			if (older != CommandHistory::s_NotFound) {
+				m_searchMatch = older;
 			}
-			tokens.emplace_back();
-			tokens.back().emplace_back(std::move(token));
+		}
+		return;
+	}
+	char keyChar = InputSystem::Get().KeyToChar(keyAction.key, keyAction.mods);
+	if (keyChar != '\0') {
+		// The current match stays the best candidate while it still contains the query
+		size_t before = m_searchMatch != CommandHistory::s_NotFound ? m_searchMatch + 1 : m_history.Size();
+		m_searchQuery.append(keyAction.repeat, keyChar);
+		m_searchMatch = m_history.FindOlder(m_searchQuery, before);
+		return;
+	}
+	switch (keyAction.key) {
+		case Key::Backspace:
+			m_searchQuery.resize(m_searchQuery.size() - std::min<size_t>(keyAction.repeat, m_searchQuery.size()));
+			m_searchMatch = m_searchQuery.empty() ? CommandHistory::s_NotFound
+				: m_history.FindOlder(m_searchQuery, m_history.Size());
+			break;
 
-			while (i < len) {
-				while (i < len && std::isspace(str[i])) { ++i; }
+		case Key::Escape:
+			_EndReverseSearch(false);
+			break;
 
-				size_t pos = i;
-				while (i < len && str[i] != ',' && str[i] != ';') { ++i; }
+		case Key::Enter:
+			_EndReverseSearch(true);
+			_SubmitInput();
+			break;
 
-				tokens.back().emplace_back(str.substr(pos, i - pos));
-				if (str[i] == ';') {
-					++i;
-					break;
-				}
-				++i;
-			}
-		}
-		tokens.emplace_back();
-		return tokens;
+		case Key::Left:
+		case Key::Right:
+		case Key::Up:
+		case Key::Down:
+		case Key::Tab:
+			_EndReverseSearch(true);
+			break;
+
+		// Modifier and function keys leave the search as it is
+		default:
+			break;
 	}
+}
 
-	void PlaylistCreateExecute(std::vector<std::vector<std::string>>& tokens) {
-		std::string name;
-		std::vector<uint64_t> ids;
+void jade::BackendConsole::_EndReverseSearch(bool accept) {
+	if (accept && m_searchMatch != CommandHistory::s_NotFound) {
+		m_commandBuffer = m_history.Get(m_searchMatch);
+	}
+	else {
+		m_commandBuffer = std::move(m_editedInput);
+	}
+	m_cursorPosition  = m_commandBuffer.size();
+	m_historyPosition = m_history.Size();
+	m_states &= ~ConsoleState::ReverseSearchBit;
+}
 
-		// todo
+namespace {
+	bool IsSeparator(char c) noexcept {
+	#if defined(_WIN32) || defined(WIN32)
+		return c == '/' || c == '\\';
+	#else
+		return c == '/';
+	#endif
 	}
 }
\ No newline at end of file
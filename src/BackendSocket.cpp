@@ -0,0 +1,351 @@
+#include <jade/backend/BackendSocket.h>
+#include <jade/Platform.h>
+#include <jade/Trace.h>
+
+#include <stdexcept>
+
+#if defined(_WIN32) || defined(WIN32)
+
+jade::BackendSocket::BackendSocket(const std::filesystem::path& path) : m_path(path) {
+	throw std::runtime_error("Socket backend relies on epoll and is not supported on this platform");
+}
+
+jade::BackendSocket::~BackendSocket() {}
+
+void jade::BackendSocket::Update(Timestep) {}
+void jade::BackendSocket::Render() {}
+
+void jade::BackendSocket::_Shutdown() noexcept {}
+
+#else
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+namespace {
+	bool IsListening(const sockaddr_un& address);
+}
+
+jade::BackendSocket::BackendSocket(const std::filesystem::path& path) : m_path(path) {
+	const std::string& native = m_path.native();
+
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if (native.size() >= sizeof(address.sun_path)) {
+		throw std::runtime_error("Control socket path '" + native + "' is too long");
+	}
+	std::memcpy(address.sun_path, native.c_str(), native.size() + 1);
+
+	try {
+		m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+		if (m_epollFd < 0) {
+			throw std::system_error(errno, std::generic_category(), "Failed to create epoll instance");
+		}
+		int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (listenFd < 0) {
+			throw std::system_error(errno, std::generic_category(), "Failed to create control socket");
+		}
+		int result = bind(listenFd, (const sockaddr*)&address, sizeof(address));
+
+		// A socket file left behind by a crashed instance refuses connections and is replaced
+		if (result != 0 && errno == EADDRINUSE && std::filesystem::is_socket(m_path) && !IsListening(address)) {
+			unlink(native.c_str());
+			result = bind(listenFd, (const sockaddr*)&address, sizeof(address));
+		}
+		if (result != 0) {
+			int error = errno;
+			close(listenFd);
+			throw std::system_error(error, std::generic_category(), "Failed to bind control socket '" + native + "'");
+		}
+		m_listenFd = listenFd;
+
+		if (listen(m_listenFd, s_ListenBacklog) != 0) {
+			throw std::system_error(errno, std::generic_category(), "Failed to listen on control socket");
+		}
+		epoll_event event = { .events = EPOLLIN, .data = { .u64 = s_NoClient } };
+		if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_listenFd, &event) != 0) {
+			throw std::system_error(errno, std::generic_category(), "Failed to watch control socket");
+		}
+	}
+	catch (...) {
+		_Shutdown();
+		throw;
+	}
+	SetMainThreadWakeupFd(m_epollFd);
+}
+
+jade::BackendSocket::~BackendSocket() {
+	_Shutdown();
+}
+
+void jade::BackendSocket::Update(Timestep) {
+	if (m_states & State::ShouldTerminateBit) {
+		if (m_tasks.GetActiveCount() == 0) m_states &= ~State::ShouldTerminateBit;
+		return;
+	}
+	epoll_event events[s_MaxEventsPerWait];
+	int eventCount = epoll_wait(m_epollFd, events, s_MaxEventsPerWait, 0);
+
+	for (int i = 0; i < eventCount; ++i) {
+		ClientID id = events[i].data.u64;
+		if (id == s_NoClient) {
+			_Accept();
+			continue;
+		}
+		auto it = m_clients.find(id);
+		if (it == m_clients.end()) {
+			continue;
+		}
+		bool isAlive = true;
+		if (events[i].events & EPOLLOUT) {
+			isAlive = _Send(id, it->second);
+		}
+		if (isAlive && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+			isAlive = _Receive(id, it->second);
+		}
+		if (!isAlive) {
+			_Close(it);
+		}
+	}
+	m_eventClient = m_viewClient;
+	_UpdateLibraryView();
+	m_eventClient = s_NoClient;
+}
+
+void jade::BackendSocket::Render() {
+	std::string_view broadcast = m_broadcast.view();
+
+	for (auto it = m_clients.begin(); it != m_clients.end();) {
+		_Client& client = it->second;
+		_AppendEvents(client.output, client.events.view());
+		_AppendEvents(client.output, broadcast);
+		client.events.str({});
+
+		// A client that stopped reading is dropped instead of buffering without bound
+		bool isAlive = client.output.size() <= s_MaxPendingOutput;
+		if (isAlive && !client.output.empty() && !client.isWaitingWritable) {
+			isAlive = _Send(it->first, client);
+		}
+		if (!isAlive || (client.isClosing && client.output.empty())) {
+			it = _Close(it);
+		}
+		else {
+			++it;
+		}
+	}
+	m_broadcast.str({});
+}
+
+void jade::BackendSocket::_Accept() {
+	while (true) {
+		int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0) {
+			if (errno == EINTR) continue;
+			return;
+		}
+		ClientID id = m_nextClientID++;
+		epoll_event event = { .events = EPOLLIN | EPOLLRDHUP, .data = { .u64 = id } };
+		if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+			close(fd);
+			continue;
+		}
+		m_clients[id].fd = fd;
+	}
+}
+
+bool jade::BackendSocket::_Receive(ClientID id, _Client& client) {
+	char buffer[s_ReadChunkSize];
+	size_t receivedBytes = 0;
+
+	// Bounded per update so one busy client can't starve the others, epoll reports the
+	// rest on the next update
+	while (!client.isClosing && receivedBytes < s_MaxReadPerUpdate) {
+		ssize_t count = recv(client.fd, buffer, sizeof(buffer), 0);
+		if (count > 0) {
+			client.input.append(buffer, (size_t)count);
+			receivedBytes += (size_t)count;
+			continue;
+		}
+		if (count == 0) {
+			client.isClosing = true;
+			break;
+		}
+		if (errno == EINTR) continue;
+		if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+		return false;
+	}
+	size_t lineStart = 0;
+	for (size_t lineEnd; (lineEnd = client.input.find('\n', lineStart)) != std::string::npos; lineStart = lineEnd + 1) {
+		std::string_view line(client.input.data() + lineStart, lineEnd - lineStart);
+		if (!line.empty() && line.back() == '\r') {
+			line.remove_suffix(1);
+		}
+		_ExecuteLine(id, client, line);
+	}
+	client.input.erase(0, lineStart);
+
+	if (client.input.size() > s_MaxLineSize) {
+		client.output += "Error: Command line is too long\n.\n";
+		client.input.clear();
+		client.isClosing = true;
+	}
+	if (!client.isClosing) {
+		return true;
+	}
+	// The last line doesn't need a newline before the peer stops sending
+	if (!client.input.empty()) {
+		_ExecuteLine(id, client, client.input);
+		client.input.clear();
+	}
+	epoll_event event = { .events = client.isWaitingWritable ? (uint32_t)EPOLLOUT : 0u, .data = { .u64 = id } };
+	return epoll_ctl(m_epollFd, EPOLL_CTL_MOD, client.fd, &event) == 0;
+}
+
+bool jade::BackendSocket::_Send(ClientID id, _Client& client) {
+	size_t sentBytes = 0;
+	while (sentBytes < client.output.size()) {
+		ssize_t count = send(client.fd, client.output.data() + sentBytes, client.output.size() - sentBytes, MSG_NOSIGNAL);
+		if (count >= 0) {
+			sentBytes += (size_t)count;
+			continue;
+		}
+		if (errno == EINTR) continue;
+		if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+		return false;
+	}
+	client.output.erase(0, sentBytes);
+
+	bool isWaitingWritable = !client.output.empty();
+	if (isWaitingWritable == client.isWaitingWritable) {
+		return true;
+	}
+	client.isWaitingWritable = isWaitingWritable;
+
+	epoll_event event = { .events = client.isClosing ? 0u : (uint32_t)(EPOLLIN | EPOLLRDHUP), .data = { .u64 = id } };
+	if (isWaitingWritable) {
+		event.events |= EPOLLOUT;
+	}
+	return epoll_ctl(m_epollFd, EPOLL_CTL_MOD, client.fd, &event) == 0;
+}
+
+jade::BackendSocket::_ClientIterator jade::BackendSocket::_Close(_ClientIterator it) {
+	epoll_ctl(m_epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+	close(it->second.fd);
+
+	if (m_viewClient == it->first) {
+		m_viewClient = s_NoClient;
+	}
+	return m_clients.erase(it);
+}
+
+void jade::BackendSocket::_Shutdown() noexcept {
+	for (auto& [id, client] : m_clients) {
+		close(client.fd);
+	}
+	m_clients.clear();
+
+	if (m_epollFd >= 0) {
+		SetMainThreadWakeupFd(-1);
+		close(m_epollFd);
+		m_epollFd = -1;
+	}
+	if (m_listenFd >= 0) {
+		close(m_listenFd);
+		unlink(m_path.c_str());
+		m_listenFd = -1;
+	}
+}
+
+namespace {
+	bool IsListening(const sockaddr_un& address) {
+		int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (fd < 0) {
+			return false;
+		}
+		bool isListening = connect(fd, (const sockaddr*)&address, sizeof(address)) == 0;
+		close(fd);
+		return isListening;
+	}
+}
+
+#endif // WIN32
+
+bool jade::BackendSocket::HasPendingWork() const {
+	if (m_states & State::ShouldTerminateBit) {
+		return m_tasks.GetActiveCount() == 0;
+	}
+	if ((m_states & State::LibraryViewPendingBit) || !m_broadcast.view().empty()) {
+		return true;
+	}
+	for (const auto& [id, client] : m_clients) {
+		bool hasOutput = !client.events.view().empty() || (!client.output.empty() && !client.isWaitingWritable);
+		if (hasOutput || (client.isClosing && client.output.empty())) {
+			return true;
+		}
+	}
+	return false;
+}
+
+std::ostream& jade::BackendSocket::Out() {
+	if (m_replyClient != s_NoClient) {
+		return m_reply;
+	}
+	auto it = m_clients.find(m_eventClient);
+	return it != m_clients.end() ? it->second.events : m_broadcast;
+}
+
+void jade::BackendSocket::_OnTaskSubmitted(TaskRegistry::TaskID id) {
+	if (m_replyClient != s_NoClient) {
+		m_taskClients[id] = m_replyClient;
+	}
+}
+
+void jade::BackendSocket::_SetTaskOutput(TaskRegistry::TaskID id) {
+	auto it = m_taskClients.find(id);
+	if (it == m_taskClients.end()) {
+		m_eventClient = s_NoClient;
+		return;
+	}
+	// Results of a task whose client disconnected go to everyone
+	m_eventClient = it->second;
+	m_taskClients.erase(it);
+}
+
+void jade::BackendSocket::_ExecuteLine(ClientID id, _Client& client, std::string_view line) {
+	JADE_TRACE_SCOPE("BackendSocket::ExecuteLine");
+
+	// A command that asks for a library page sets the bit again, the page then goes
+	// to this client
+	uint64_t viewPending = m_states & State::LibraryViewPendingBit;
+	m_states &= ~State::LibraryViewPendingBit;
+
+	m_replyClient = id;
+	ExecuteCommand(line);
+	m_replyClient = s_NoClient;
+
+	if (m_states & State::LibraryViewPendingBit) {
+		m_viewClient = id;
+	}
+	m_states |= viewPending;
+
+	client.output += m_reply.view();
+	client.output += ".\n";
+	m_reply.str({});
+}
+
+void jade::BackendSocket::_AppendEvents(std::string& output, std::string_view events) {
+	while (!events.empty()) {
+		size_t lineEnd = events.find('\n');
+		std::string_view line = events.substr(0, lineEnd);
+
+		output += "* ";
+		output += line;
+		output += '\n';
+		events.remove_prefix(lineEnd == std::string_view::npos ? events.size() : lineEnd + 1);
+	}
+}
\ No newline at end of file
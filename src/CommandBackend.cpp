@@ -0,0 +1,481 @@
+#include <jade/backend/CommandBackend.h>
+#include <jade/App.h>
+#include <jade/Profiler.h>
+#include <jade/Trace.h>
+
+#include <charconv>
+#include <filesystem>
+
+namespace {
+	void FormatTrack(std::ostream& out, const jade::MusicLibrary::TrackElement& track);
+}
+
+namespace {
+	using Param       = jade::CommandParser::Param;
+	using ValueType   = jade::CommandParser::ValueType;
+	using ValueSource = jade::CommandParser::ValueSource;
+
+	constexpr Param g_LibraryShowParams[] = {
+		{ "sort:",  ValueType::String },
+		{ "order:", ValueType::String },
+		{ "page:",  ValueType::Unsigned },
+		{ "size:",  ValueType::Unsigned }
+	};
+	constexpr Param g_LibraryAddParams[] = {
+		{ "artists:", ValueType::List, false, ValueSource::ArtistName },
+		{ "feat:",    ValueType::List, false, ValueSource::ArtistName },
+		{ "name:",    ValueType::String, true, ValueSource::TrackName },
+		{ "path:",    ValueType::String, true, ValueSource::Path }
+	};
+	constexpr Param g_PathParams[]            = { { "path:", ValueType::String, true, ValueSource::Path } };
+	constexpr Param g_OptionalPathParams[]    = { { "path:", ValueType::String, false, ValueSource::Path } };
+	constexpr Param g_TrackIDParams[]         = { { "id:", ValueType::Unsigned, true, ValueSource::TrackID } };
+	constexpr Param g_TaskIDParams[]          = { { "id:", ValueType::Unsigned, true } };
+	constexpr Param g_VolumeParams[]          = { { "%:", ValueType::Number, true } };
+	constexpr Param g_SpeedParams[]           = { { "x:", ValueType::Number, true } };
+	constexpr Param g_PlaylistCreateParams[] = {
+		{ "name:", ValueType::String, true },
+		{ "ids:",  ValueType::List, true, ValueSource::TrackID }
+	};
+
+	const std::map<std::string_view, jade::CommandBackend::CommandSpec> g_CommandMap = {
+		{ "close",		     { jade::CommandBackend::Command::Close, {} } },
+		{ "close_unsaved",   { jade::CommandBackend::Command::CloseUnsaved, {} } },
+
+		{ "lib_add",         { jade::CommandBackend::Command::LibraryAdd, g_LibraryAddParams } },
+		{ "lib_import",      { jade::CommandBackend::Command::LibraryImport, g_PathParams } },
+		{ "lib_save",        { jade::CommandBackend::Command::LibrarySave, {} } },
+		{ "lib_show",        { jade::CommandBackend::Command::LibraryShow, g_LibraryShowParams } },
+		{ "lib_next",        { jade::CommandBackend::Command::LibraryNext, {} } },
+		{ "lib_prev",        { jade::CommandBackend::Command::LibraryPrev, {} } },
+
+		{ "play",            { jade::CommandBackend::Command::Play, g_TrackIDParams } },
+		{ "pause",           { jade::CommandBackend::Command::Pause, {} } },
+		{ "resume",          { jade::CommandBackend::Command::Resume, {} } },
+		{ "volume",          { jade::CommandBackend::Command::Volume, g_VolumeParams } },
+		{ "speed",			 { jade::CommandBackend::Command::Speed, g_SpeedParams } },
+		{ "queue",           { jade::CommandBackend::Command::Enqueue, g_TrackIDParams } },
+		{ "next",            { jade::CommandBackend::Command::Next, {} } },
+
+		{ "stats",           { jade::CommandBackend::Command::Stats, {} } },
+		{ "trace_dump",      { jade::CommandBackend::Command::TraceDump, g_OptionalPathParams } },
+
+		{ "tasks",           { jade::CommandBackend::Command::Tasks, {} } },
+		{ "cancel",          { jade::CommandBackend::Command::CancelTask, g_TaskIDParams } },
+
+		{ "playlist_create", { jade::CommandBackend::Command::PlaylistCreate, g_PlaylistCreateParams } }
+	};
+}
+
+jade::CommandBackend::CommandBackend() {
+	m_tasks.SetConcurrencyLimit(TaskType::AsyncMusicLibraryAdd, 2);
+	m_musicLibrary.SetMusicLibrary(&MusicLibrary::Get());
+
+	EventSystem::Get().Subscribe<OnTaskEnded>(50, [this](const OnTaskEnded& e) {
+		if (e.status == OnTaskEnded::Status::Failed) {
+			ShowError(e.errorMsg);
+			return;
+		}
+		if (e.status == OnTaskEnded::Status::Success) {
+			DispatchTaskResult(e);
+			return;
+		}
+	});
+	EventSystem::Get().Subscribe<OnAsyncTaskEnded>(50, [this](OnAsyncTaskEnded& e) {
+		TaskRegistry::TaskID id = m_tasks.OnTaskEnded(e);
+
+		_SetTaskOutput(id);
+		if (e.status == OnTaskEnded::Status::Failed) {
+			ShowError(e.errorMsg);
+		}
+		else if (e.status == OnTaskEnded::Status::Cancelled && !(m_states & State::AllTasksCancelledBit)) {
+			Out() << "Task " << id << " has been cancelled\n";
+		}
+		else if (e.status == OnTaskEnded::Status::Success) {
+			DispatchTaskResult(e);
+		}
+		_SetTaskOutput(TaskRegistry::s_InvalidID);
+	});
+	EventSystem::Get().Subscribe<OnTrackStarted>(50, [this](const OnTrackStarted& e) {
+		MusicLibrary::TrackIterator track = m_musicLibrary.GetTrackByID(e.trackID);
+		if (track != m_musicLibrary.TrackIteratorEnd()) {
+			Out() << "Now playing '" << track->second.name << "'\n";
+		}
+	});
+	EventSystem::Get().Subscribe<OnPlaybackFinished>(50, [this]() {
+		Out() << "Track has finished playing\n";
+	});
+	EventSystem::Get().Subscribe<OnApplicationClose>(50, [this](OnApplicationClose& e) {
+		if (m_tasks.GetActiveCount() > 0) {
+			CancelTasks();
+			e.closeState = e.WaitForOthers;
+			m_states |= State::ShouldTerminateBit;
+		}
+	});
+}
+
+const std::map<std::string_view, jade::CommandBackend::CommandSpec>& jade::CommandBackend::GetCommands() noexcept {
+	return g_CommandMap;
+}
+
+void jade::CommandBackend::ShowError(const std::string& error) {
+	Out() << "Error: " << error << '\n';
+	++m_errorCount;
+}
+
+void jade::CommandBackend::CancelTasks() {
+	if (!(m_states & State::AllTasksCancelledBit)) {
+		m_tasks.CancelAll();
+		m_states |= State::AllTasksCancelledBit;
+	}
+}
+
+void jade::CommandBackend::DispatchTaskResult(const OnTaskEnded&) {
+}
+
+void jade::CommandBackend::DispatchTaskResult(const OnAsyncTaskEnded& endedTask) {
+	switch (endedTask.whatTask) {
+		case TaskType::AsyncMusicLibrarySave:
+			Out() << "Music library changes have been successfully saved\n";
+			break;
+
+		case TaskType::AsyncMusicLibraryAdd:
+			Out() << "Track has been successfully added to music library\n";
+			break;
+
+		case TaskType::AsyncMusicLibraryImport:
+			Out() << "Tracks have been successfully imported to music library\n";
+			break;
+
+		case TaskType::AsyncCount:
+		case TaskType::None:
+			break;
+	}
+}
+
+bool jade::CommandBackend::ExecuteCommand(std::string_view cmd) {
+	if (!m_commandParser.Parse(cmd)) {
+		ShowError(m_commandParser.GetError());
+		return false;
+	}
+	std::string_view name = m_commandParser.GetCommandName();
+	if (name.empty()) {
+		return true;
+	}
+	auto it = g_CommandMap.find(name);
+	if (it == g_CommandMap.cend()) {
+		Out() << "Unknown command '" << name << "'\n";
+		return false;
+	}
+	if (!m_commandParser.Bind(it->second.params)) {
+		ShowError(m_commandParser.GetError());
+		return false;
+	}
+	Command command = it->second.command;
+	if ((size_t)command >= m_dispatchCmdTable.size()) {
+		Out() << "Command '" << name << "' is not supported yet\n";
+		return false;
+	}
+	((*this).*m_dispatchCmdTable[(size_t)command])(m_commandParser.GetArguments());
+	return true;
+}
+
+void jade::CommandBackend::ExecuteCloseCmd(const CommandParser::Arguments&) {
+	jade::Application::Get().CloseRequest();
+}
+
+void jade::CommandBackend::ExecuteCloseUnsavedCmd(const CommandParser::Arguments&) {
+	jade::Application::Get().CloseUnsavedRequest();
+}
+
+void jade::CommandBackend::ExecuteLibraryShowCmd(const CommandParser::Arguments& args) {
+	if (m_musicLibrary.TrackIteratorBegin() == m_musicLibrary.TrackIteratorEnd()) {
+		m_libraryView.Close();
+		Out() << "Music library is empty\n";
+		return;
+	}
+	LibraryView::SortKey sortKey = LibraryView::SortKey::ID;
+	std::string_view sort = args.GetString("sort:", "id");
+
+	if (sort == "name") sortKey = LibraryView::SortKey::Name;
+	else if (sort == "artist") sortKey = LibraryView::SortKey::Artist;
+	else if (sort == "duration") sortKey = LibraryView::SortKey::Duration;
+	else if (sort != "id") {
+		ShowError("Unknown sort key '" + std::string(sort) + "', expected id, name, artist or duration");
+		return;
+	}
+	std::string_view order = args.GetString("order:", "asc");
+	if (order != "asc" && order != "desc") {
+		ShowError("Unknown order '" + std::string(order) + "', expected asc or desc");
+		return;
+	}
+	bool descending = order == "desc";
+	size_t pageSize = args.GetUnsigned("size:", LibraryView::s_DefaultPageSize);
+	size_t page = args.GetUnsigned("page:", 1);
+
+	m_libraryView.Open(m_musicLibrary, sortKey, descending, pageSize, page > 0 ? page - 1 : 0);
+	m_states |= State::LibraryViewPendingBit;
+}
+
+void jade::CommandBackend::ExecuteLibraryNextCmd(const CommandParser::Arguments&) {
+	if (!m_libraryView.IsOpen()) {
+		Out() << "No library view is open, use lib_show first\n";
+		return;
+	}
+	if (m_libraryView.IsReady()) {
+		m_libraryView.SetPage(m_libraryView.GetPage() + 1);
+	}
+	m_states |= State::LibraryViewPendingBit;
+}
+
+void jade::CommandBackend::ExecuteLibraryPrevCmd(const CommandParser::Arguments&) {
+	if (!m_libraryView.IsOpen()) {
+		Out() << "No library view is open, use lib_show first\n";
+		return;
+	}
+	if (m_libraryView.IsReady() && m_libraryView.GetPage() > 0) {
+		m_libraryView.SetPage(m_libraryView.GetPage() - 1);
+	}
+	m_states |= State::LibraryViewPendingBit;
+}
+
+void jade::CommandBackend::ExecuteLibrarySaveCmd(const CommandParser::Arguments&) {
+	_SubmitTask(TaskType::AsyncMusicLibrarySave, "lib_save", [this](const std::shared_ptr<FutureTask>& task) {
+		return m_musicLibrary.SaveChanges(task);
+	});
+}
+
+void jade::CommandBackend::ExecuteLibraryAddCmd(const CommandParser::Arguments& args) {
+	std::span<const std::string_view> artistList = args.GetList("artists:");
+	std::span<const std::string_view> featList   = args.GetList("feat:");
+
+	std::vector<std::string> artists(artistList.begin(), artistList.end());
+	std::vector<std::string> feat(featList.begin(), featList.end());
+	std::string name(args.GetString("name:"));
+	std::string path(args.GetString("path:"));
+
+	std::string description = "lib_add " + name;
+	_SubmitTask(TaskType::AsyncMusicLibraryAdd, std::move(description),
+	[this, artists = std::move(artists), feat = std::move(feat), name = std::move(name), path = std::move(path)]
+	(const std::shared_ptr<FutureTask>& task) {
+		return m_musicLibrary.Add(artists, feat, name, path, task);
+	});
+}
+
+void jade::CommandBackend::ExecuteLibraryImportCmd(const CommandParser::Arguments& args) {
+	std::string path(args.GetString("path:"));
+	std::string description = "lib_import " + path;
+	_SubmitTask(TaskType::AsyncMusicLibraryImport, std::move(description),
+	[this, path = std::move(path)](const std::shared_ptr<FutureTask>& task) {
+		return m_musicLibrary.Import(path, task);
+	});
+}
+
+void jade::CommandBackend::ExecutePlayCmd(const CommandParser::Arguments& args) {
+	uint64_t id = args.GetUnsigned("id:");
+	MusicLibrary::TrackIterator track = m_musicLibrary.GetTrackByID(id);
+
+	if (track == m_musicLibrary.TrackIteratorEnd()) {
+		Out() << "No track found with ID = " << id << '\n';
+	}
+	else {
+		Application::Get().Player().Play(track->second);
+	}
+}
+
+void jade::CommandBackend::ExecutePauseCmd(const CommandParser::Arguments&) {
+	Application::Get().Player().Pause();
+}
+
+void jade::CommandBackend::ExecuteResumeCmd(const CommandParser::Arguments&) {
+	Application::Get().Player().Resume();
+}
+
+void jade::CommandBackend::ExecuteVolumeCmd(const CommandParser::Arguments& args) {
+	float volume = (float)args.GetNumber("%:");
+	Application::Get().Player().SetVolume(volume * 0.01f);
+
+	Out() << "Player sound volume has been set to " << volume << "%\n";
+}
+
+void jade::CommandBackend::ExecuteSpeedCmd(const CommandParser::Arguments& args) {
+	double speed = args.GetNumber("x:");
+	Application::Get().Player().SetSpeed(speed);
+
+	Out() << "Player speed has been set to " << speed << "\n";
+}
+
+void jade::CommandBackend::ExecuteEnqueueCmd(const CommandParser::Arguments& args) {
+	uint64_t id = args.GetUnsigned("id:");
+	MusicLibrary::TrackIterator track = m_musicLibrary.GetTrackByID(id);
+
+	if (track == m_musicLibrary.TrackIteratorEnd()) {
+		Out() << "No track found with ID = " << id << '\n';
+		return;
+	}
+	jade::Player& player = Application::Get().Player();
+	player.Enqueue(track->second);
+
+	Out() << "Track '" << track->second.name << "' has been queued, " << player.GetQueueSize() << " waiting\n";
+}
+
+void jade::CommandBackend::ExecuteNextCmd(const CommandParser::Arguments&) {
+	if (!Application::Get().Player().Skip()) {
+		Out() << "Play queue is empty\n";
+	}
+}
+
+void jade::CommandBackend::ExecuteStatsCmd(const CommandParser::Arguments&) {
+	if (Profiler::IsEnabled()) {
+		Out() << Profiler::GetConst().Report();
+	}
+	else {
+		Out() << "Profiler is disabled, rebuild with JADE_ENABLE_PROFILER to collect timings\n";
+	}
+	EventSystem::Metrics metrics = EventSystem::GetConst().GetMetrics();
+	Out() << "Event system:\n"
+		<< "\t- registered: " << metrics.registered << ", dispatched: " << metrics.dispatched << '\n'
+		<< "\t- spilled: " << metrics.spilled << ", blocked: " << metrics.blocked
+		<< ", coalesced: " << metrics.coalesced << ", dropped: " << metrics.dropped << '\n'
+		<< "\t- peak queue depth: " << metrics.peakQueueDepth << ", storage: " << metrics.storageBytes << " bytes\n";
+}
+
+void jade::CommandBackend::ExecuteTraceDumpCmd(const CommandParser::Arguments& args) {
+	if (!Tracer::IsEnabled()) {
+		Out() << "Tracing is disabled, rebuild with JADE_ENABLE_TRACING to record traces\n";
+		return;
+	}
+	std::filesystem::path path = Config::Paths::TraceFile;
+	if (args.Has("path:")) {
+		path = args.GetString("path:");
+	}
+	try {
+		Tracer::Get().DumpChromeTrace(path);
+	}
+	catch (const std::runtime_error& error) {
+		ShowError(error.what());
+		return;
+	}
+	Out() << "Trace has been written to '" << path.string() << "'\n";
+}
+
+void jade::CommandBackend::ExecuteTasksCmd(const CommandParser::Arguments&) {
+	std::vector<TaskRegistry::TaskInfo> tasks = m_tasks.GetTasks();
+	if (tasks.empty()) {
+		Out() << "No tasks are running\n";
+		return;
+	}
+	for (const TaskRegistry::TaskInfo& task : tasks) {
+		Out() << "\t- Task " << task.id << ": " << task.description << " [";
+		switch (task.state) {
+			case TaskRegistry::TaskState::Queued:
+				Out() << "queued";
+				break;
+
+			case TaskRegistry::TaskState::Running:
+				Out() << "running " << (int)(task.progress * 100.0f) << '%';
+				break;
+
+			case TaskRegistry::TaskState::Cancelling:
+				Out() << "cancelling";
+				break;
+		}
+		Out() << "]\n";
+	}
+}
+
+void jade::CommandBackend::ExecuteCancelTaskCmd(const CommandParser::Arguments& args) {
+	TaskRegistry::TaskID id = args.GetUnsigned("id:");
+
+	switch (m_tasks.Cancel(id)) {
+		case TaskRegistry::CancelResult::NotFound:
+			Out() << "No task found with ID = " << id << '\n';
+			break;
+
+		case TaskRegistry::CancelResult::Dropped:
+			Out() << "Task " << id << " has been cancelled\n";
+			break;
+
+		case TaskRegistry::CancelResult::Cancelling:
+			Out() << "Task " << id << " is being cancelled\n";
+			break;
+
+		case TaskRegistry::CancelResult::NotCancellable:
+			ShowError("Task " + std::to_string(id) + " can't be cancelled, it will finish on its own");
+			break;
+	}
+}
+
+void jade::CommandBackend::ExecutePlaylistCreateCmd(const CommandParser::Arguments& args) {
+	std::span<const std::string_view> idList = args.GetList("ids:");
+
+	std::vector<uint64_t> ids;
+	ids.reserve(idList.size());
+	for (std::string_view value : idList) {
+		uint64_t id = 0;
+		auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), id);
+		if (error != std::errc() || end != value.data() + value.size()) {
+			ShowError("'" + std::string(value) + "' is not a track ID");
+			return;
+		}
+		ids.push_back(id);
+	}
+	std::string name(args.GetString("name:"));
+	std::string error = m_musicLibrary.CreatePlaylist(name, ids);
+
+	Out() << "Playlist '" << name << "' has been created\n";
+	if (!error.empty()) {
+		ShowError("Track IDs " + error);
+	}
+}
+
+void jade::CommandBackend::_SubmitTask(TaskType type, std::string description, TaskRegistry::Launcher&& launcher) {
+	TaskRegistry::TaskID id = m_tasks.Submit(type, std::move(description), std::move(launcher));
+	_OnTaskSubmitted(id);
+
+	if (m_tasks.GetState(id) == TaskRegistry::TaskState::Queued) {
+		Out() << "Task " << id << " has been queued\n";
+	}
+	else {
+		Out() << "Task " << id << " has been started\n";
+	}
+}
+
+void jade::CommandBackend::_UpdateLibraryView() {
+	if ((m_states & State::LibraryViewPendingBit) && m_libraryView.Update()) {
+		_ShowLibraryPage();
+		m_states &= ~State::LibraryViewPendingBit;
+	}
+}
+
+void jade::CommandBackend::_ShowLibraryPage() {
+	for (const MusicLibrary::TrackIterator& track : m_libraryView.GetVisibleTracks()) {
+		FormatTrack(Out(), track->second);
+	}
+	Out() << "Page " << m_libraryView.GetPage() + 1 << " of " << m_libraryView.GetPageCount()
+		<< " (" << m_libraryView.GetTrackCount() << " tracks), lib_next and lib_prev to scroll\n";
+}
+
+namespace {
+	void FormatTrack(std::ostream& out, const jade::MusicLibrary::TrackElement& track) {
+		out << "\t- ID " << track.id << ": ";
+		for (size_t i = 0; i < track.artists.size(); ++i) {
+			out << track.artists[i];
+			if (i + 1 < track.artists.size()) {
+				out << ", ";
+			}
+		}
+		out << " - " << track.name;
+		if (!track.feat.empty()) {
+			out << " (feat ";
+			for (size_t i = 0; i < track.feat.size(); ++i) {
+				out << track.feat[i];
+				if (i + 1 < track.feat.size()) {
+					out << ", ";
+				}
+			}
+			out << ')';
+		}
+		out << '\n';
+	}
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include <jade/backend/CommandHistory.h>
+
+#include <algorithm>
+
+jade::CommandHistory::CommandHistory(const std::filesystem::path& path) {
+	Open(path);
+}
+
+void jade::CommandHistory::Open(const std::filesystem::path& path) {
+	m_chars.clear();
+	m_offsets.clear();
+	m_index.clear();
+	{
+		std::ifstream file(path, std::ios::binary);
+		std::string line;
+		while (std::getline(file, line)) {
+			if (!line.empty() && line.back() == '\r') {
+				line.pop_back();
+			}
+			if (!line.empty()) {
+				_Add(line);
+			}
+		}
+	}
+	m_file.close();
+	m_file.open(path, std::ios::out | std::ios::app | std::ios::binary);
+}
+
+void jade::CommandHistory::Append(std::string_view command) {
+	if (command.empty() || command.find('\n') != std::string_view::npos) {
+		return;
+	}
+	if (!m_offsets.empty() && Get(m_offsets.size() - 1) == command) {
+		return;
+	}
+	_Add(command);
+
+	if (m_file.is_open()) {
+		m_file.write(command.data(), (std::streamsize)command.size());
+		m_file.put('\n');
+		m_file.flush();
+	}
+}
+
+std::string_view jade::CommandHistory::Get(size_t index) const noexcept {
+	uint64_t begin = m_offsets[index];
+	uint64_t end   = index + 1 < m_offsets.size() ? m_offsets[index + 1] : m_chars.size();
+	return std::string_view(m_chars).substr(begin, end - begin);
+}
+
+size_t jade::CommandHistory::FindOlder(std::string_view query, size_t before) const {
+	before = std::min(before, m_offsets.size());
+
+	// Too short to index, entries are scanned from the newest
+	if (query.size() < 3) {
+		for (size_t i = before; i-- > 0;) {
+			if (Get(i).find(query) != std::string_view::npos) {
+				return i;
+			}
+		}
+		return s_NotFound;
+	}
+	const std::vector<uint32_t>* rarest = nullptr;
+	for (size_t i = 0; i + 3 <= query.size(); ++i) {
+		auto it = m_index.find(_MakeTrigram(query, i));
+		if (it == m_index.end()) {
+			return s_NotFound;
+		}
+		if (rarest == nullptr || it->second.size() < rarest->size()) {
+			rarest = &it->second;
+		}
+	}
+	auto end = std::lower_bound(rarest->begin(), rarest->end(), (uint32_t)before);
+	for (auto it = std::make_reverse_iterator(end); it != rarest->rend(); ++it) {
+		if (Get(*it).find(query) != std::string_view::npos) {
+			return *it;
+		}
+	}
+	return s_NotFound;
+}
+
+jade::CommandHistory::_Trigram jade::CommandHistory::_MakeTrigram(std::string_view text, size_t position) noexcept {
+	return (_Trigram)(unsigned char)text[position] << 16 |
+		(_Trigram)(unsigned char)text[position + 1] << 8 |
+		(_Trigram)(unsigned char)text[position + 2];
+}
+
+void jade::CommandHistory::_Add(std::string_view command) {
+	uint32_t entry = (uint32_t)m_offsets.size();
+	m_offsets.push_back(m_chars.size());
+	m_chars.append(command);
+
+	for (size_t i = 0; i + 3 <= command.size(); ++i) {
+		std::vector<uint32_t>& entries = m_index[_MakeTrigram(command, i)];
+		if (entries.empty() || entries.back() != entry) {
+			entries.push_back(entry);
+		}
+	}
+}
\ No newline at end of file
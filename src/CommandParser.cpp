@@ -0,0 +1,147 @@
+#include <jade/backend/CommandParser.h>
+
+#include <charconv>
+
+namespace {
+	bool IsSpace(char c) noexcept { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+	std::string_view Trim(std::string_view text) noexcept {
+		while (!text.empty() && IsSpace(text.front())) text.remove_prefix(1);
+		while (!text.empty() && IsSpace(text.back())) text.remove_suffix(1);
+		return text;
+	}
+
+	template <typename T>
+	bool ParseNumber(std::string_view text, T& value) noexcept {
+		std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+		return result.ec == std::errc() && result.ptr == text.data() + text.size();
+	}
+}
+
+bool jade::CommandParser::Arguments::Has(std::string_view name) const noexcept {
+	const _Value* value = _Find(name);
+	return value != nullptr && value->isSet;
+}
+
+std::string_view jade::CommandParser::Arguments::GetString(std::string_view name, std::string_view fallback) const noexcept {
+	const _Value* value = _Find(name);
+	return value != nullptr && value->isSet ? value->values.front() : fallback;
+}
+
+std::span<const std::string_view> jade::CommandParser::Arguments::GetList(std::string_view name) const noexcept {
+	const _Value* value = _Find(name);
+	return value != nullptr && value->isSet ? value->values : std::span<const std::string_view>();
+}
+
+uint64_t jade::CommandParser::Arguments::GetUnsigned(std::string_view name, uint64_t fallback) const noexcept {
+	const _Value* value = _Find(name);
+	return value != nullptr && value->isSet ? value->unsignedValue : fallback;
+}
+
+double jade::CommandParser::Arguments::GetNumber(std::string_view name, double fallback) const noexcept {
+	const _Value* value = _Find(name);
+	return value != nullptr && value->isSet ? value->numberValue : fallback;
+}
+
+const jade::CommandParser::Arguments::_Value* jade::CommandParser::Arguments::_Find(std::string_view name) const noexcept {
+	for (size_t i = 0; i < m_schema.size(); ++i) {
+		if (m_schema[i].name == name) {
+			return &m_values[i];
+		}
+	}
+	return nullptr;
+}
+
+bool jade::CommandParser::Parse(std::string_view line) {
+	m_command = {};
+	m_packs.clear();
+	m_values.clear();
+	m_error.clear();
+
+	size_t i = 0;
+	size_t length = line.size();
+
+	while (i < length && IsSpace(line[i])) ++i;
+	size_t commandStart = i;
+	while (i < length && !IsSpace(line[i])) ++i;
+	m_command = line.substr(commandStart, i - commandStart);
+
+	while (true) {
+		while (i < length && IsSpace(line[i])) ++i;
+		if (i >= length) {
+			break;
+		}
+		size_t nameStart = i;
+		while (i < length && !IsSpace(line[i]) && line[i] != ':') ++i;
+		if (i >= length || line[i] != ':') {
+			return _Fail("Parameter pack name was not specified");
+		}
+		++i;
+
+		_Pack pack = {
+			.name  = line.substr(nameStart, i - nameStart),
+			.first = (uint32_t)m_values.size()
+		};
+		while (i < length) {
+			size_t valueStart = i;
+			while (i < length && line[i] != ',' && line[i] != ';') ++i;
+
+			std::string_view value = Trim(line.substr(valueStart, i - valueStart));
+			if (!value.empty()) {
+				m_values.push_back(value);
+			}
+			if (i >= length || line[i++] == ';') {
+				break;
+			}
+		}
+		pack.count = (uint32_t)m_values.size() - pack.first;
+		m_packs.push_back(pack);
+	}
+	return true;
+}
+
+bool jade::CommandParser::Bind(Schema schema) {
+	m_error.clear();
+	m_arguments.m_schema = schema;
+	m_arguments.m_values.assign(schema.size(), Arguments::_Value());
+
+	for (const _Pack& pack : m_packs) {
+		size_t index = 0;
+		while (index < schema.size() && schema[index].name != pack.name) ++index;
+
+		if (index == schema.size()) {
+			return _Fail("Unknown parameter pack '", pack.name, "'");
+		}
+		Arguments::_Value& value = m_arguments.m_values[index];
+		if (value.isSet) {
+			return _Fail("Parameter pack '", pack.name, "' was specified twice");
+		}
+		if (pack.count == 0) {
+			return _Fail("Parameter pack '", pack.name, "' has no value");
+		}
+		ValueType type = schema[index].type;
+		if (type != ValueType::List && pack.count > 1) {
+			return _Fail("Parameter pack '", pack.name, "' takes a single value");
+		}
+		value.values = std::span<const std::string_view>(m_values.data() + pack.first, pack.count);
+		value.isSet  = true;
+
+		if (type == ValueType::Unsigned && !ParseNumber(value.values.front(), value.unsignedValue)) {
+			return _Fail("Parameter pack '", pack.name, "' expects an unsigned integer");
+		}
+		if (type == ValueType::Number && !ParseNumber(value.values.front(), value.numberValue)) {
+			return _Fail("Parameter pack '", pack.name, "' expects a number");
+		}
+	}
+	for (size_t i = 0; i < schema.size(); ++i) {
+		if (schema[i].isRequired && !m_arguments.m_values[i].isSet) {
+			return _Fail("Parameter pack '", schema[i].name, "' was not specified");
+		}
+	}
+	return true;
+}
+
+bool jade::CommandParser::_Fail(std::string_view message, std::string_view pack, std::string_view suffix) {
+	m_error.assign(message).append(pack).append(suffix);
+	return false;
+}
\ No newline at end of file
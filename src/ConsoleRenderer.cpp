@@ -0,0 +1,83 @@
+#include <jade/backend/ConsoleRenderer.h>
+
+#include <cstdio>
+#include <algorithm>
+
+jade::ConsoleRenderer::~ConsoleRenderer() {
+	// Leaves the terminal on a clean line, the input line is not part of the log
+	m_frame.clear();
+	if (m_isLineShown) {
+		m_frame += "\r\33[2K";
+	}
+	m_frame += m_output.view();
+	_Write();
+}
+
+void jade::ConsoleRenderer::SetInputLine(std::string_view prompt, std::string_view text, size_t cursor) {
+	m_inputLine.assign(prompt);
+	m_inputLine.append(text);
+	m_inputCursor = prompt.size() + std::min(cursor, text.size());
+}
+
+bool jade::ConsoleRenderer::IsDirty() const noexcept {
+	return !m_isLineShown || !m_output.view().empty() || m_inputLine != m_shownLine || m_inputCursor != m_shownCursor;
+}
+
+void jade::ConsoleRenderer::Present() {
+	m_frame.clear();
+
+	if (!m_output.view().empty()) {
+		if (m_isLineShown) {
+			m_frame += "\r\33[2K";
+		}
+		m_frame += m_output.view();
+		if (m_frame.back() != '\n') {
+			m_frame += '\n';
+		}
+		m_output.str({});
+
+		m_shownLine.clear();
+		m_shownCursor = 0;
+		m_isLineShown = false;
+	}
+
+	if (!m_isLineShown) {
+		m_frame += m_inputLine;
+		m_shownCursor = m_inputLine.size();
+	}
+	else if (m_inputLine != m_shownLine) {
+		size_t common = std::mismatch(
+			m_inputLine.begin(), m_inputLine.end(), m_shownLine.begin(), m_shownLine.end()
+		).first - m_inputLine.begin();
+
+		_MoveCursor(m_shownCursor, common);
+		m_frame.append(m_inputLine, common);
+		if (m_shownLine.size() > m_inputLine.size()) {
+			m_frame += "\33[K";
+		}
+		m_shownCursor = m_inputLine.size();
+	}
+	_MoveCursor(m_shownCursor, m_inputCursor);
+
+	m_shownLine   = m_inputLine;
+	m_shownCursor = m_inputCursor;
+	m_isLineShown = true;
+	_Write();
+}
+
+void jade::ConsoleRenderer::_MoveCursor(size_t from, size_t to) {
+	if (from == to) {
+		return;
+	}
+	m_frame += "\33[";
+	m_frame += std::to_string(from < to ? to - from : from - to);
+	m_frame += from < to ? 'C' : 'D';
+}
+
+void jade::ConsoleRenderer::_Write() {
+	if (m_frame.empty()) {
+		return;
+	}
+	std::fwrite(m_frame.data(), 1, m_frame.size(), stdout);
+	std::fflush(stdout);
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include <jade/Core.h>
+#include <jade/Trace.h>
+
+#include <stdexcept>
+
+namespace {
+	constexpr size_t g_NoWorker = SIZE_MAX;
+
+	jade::ThreadPool* g_ThreadPool = nullptr;
+
+	thread_local const jade::ThreadPool* g_CurrentPool = nullptr;
+	thread_local size_t                  g_CurrentWorker = g_NoWorker;
+}
+
+jade::ThreadPool::ThreadPool(size_t workerCount) {
+	if (g_ThreadPool != nullptr) {
+		throw std::runtime_error("Thread pool is already created");
+	}
+	if (workerCount == 0) {
+		throw std::invalid_argument("Thread pool needs at least one worker");
+	}
+	m_workers.reserve(workerCount);
+	for (size_t i = 0; i < workerCount; ++i) {
+		m_workers.emplace_back(std::make_unique<_Worker>());
+	}
+	for (size_t i = 0; i < workerCount; ++i) {
+		m_workers[i]->thread = std::thread(&ThreadPool::_WorkerLoop, this, i);
+	}
+	g_ThreadPool = this;
+}
+
+jade::ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_stopping.store(true, std::memory_order_relaxed);
+	}
+	m_sleepCondition.notify_all();
+
+	for (std::unique_ptr<_Worker>& worker : m_workers) {
+		worker->thread.join();
+	}
+	g_ThreadPool = nullptr;
+}
+
+jade::ThreadPool& jade::ThreadPool::Get() noexcept { return *g_ThreadPool; }
+
+size_t jade::ThreadPool::DefaultWorkerCount() noexcept {
+	size_t hardwareCount = std::thread::hardware_concurrency();
+	return hardwareCount > 2 ? hardwareCount - 1 : 2;
+}
+
+bool jade::ThreadPool::RunPendingJob() {
+	Job job;
+	if (!_TryPop(g_CurrentPool == this ? g_CurrentWorker : g_NoWorker, job)) {
+		return false;
+	}
+	job();
+	return true;
+}
+
+bool jade::ThreadPool::IsWorkerThread() const noexcept {
+	return g_CurrentPool == this;
+}
+
+void jade::ThreadPool::_Push(Job&& job, TaskPriority priority) {
+	size_t workerIndex = g_CurrentPool == this ?
+		g_CurrentWorker : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+	{
+		_Worker& worker = *m_workers[workerIndex];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		worker.jobs[(size_t)priority].emplace_back(std::move(job));
+	}
+	m_pendingCount.fetch_add(1, std::memory_order_release);
+	{
+		// Pairs with the predicate check in _WorkerLoop so the notification cannot be lost
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+	m_sleepCondition.notify_one();
+}
+
+// Victims are tried without waiting for their lock first. A pass that skipped a locked
+// victim is repeated with blocking locks, a job behind a briefly held lock would
+// otherwise keep the pending count non-zero and the worker spinning instead of asleep.
+bool jade::ThreadPool::_TryPop(size_t workerIndex, Job& job) {
+	if (m_pendingCount.load(std::memory_order_acquire) == 0) {
+		return false;
+	}
+	bool isContended = false;
+	if (_TryPopPass(workerIndex, job, false, isContended)) {
+		return true;
+	}
+	return isContended && _TryPopPass(workerIndex, job, true, isContended);
+}
+
+bool jade::ThreadPool::_TryPopPass(size_t workerIndex, Job& job, bool isBlocking, bool& isContended) {
+	size_t workerCount = m_workers.size();
+
+	for (size_t priority = 0; priority < s_PriorityCount; ++priority) {
+		if (workerIndex != g_NoWorker) {
+			_Worker& worker = *m_workers[workerIndex];
+			std::lock_guard<std::mutex> lock(worker.mutex);
+
+			std::deque<Job>& jobs = worker.jobs[priority];
+			if (!jobs.empty()) {
+				job = std::move(jobs.back());
+				jobs.pop_back();
+				m_pendingCount.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		size_t start = workerIndex == g_NoWorker ? 0 : workerIndex + 1;
+		for (size_t i = 0; i < workerCount; ++i) {
+			size_t victimIndex = (start + i) % workerCount;
+			if (victimIndex == workerIndex) {
+				continue;
+			}
+			_Worker& victim = *m_workers[victimIndex];
+			std::unique_lock<std::mutex> lock(victim.mutex, std::defer_lock);
+			if (isBlocking) {
+				lock.lock();
+			}
+			else if (!lock.try_lock()) {
+				isContended = true;
+				continue;
+			}
+			std::deque<Job>& jobs = victim.jobs[priority];
+			if (!jobs.empty()) {
+				job = std::move(jobs.front());
+				jobs.pop_front();
+				m_pendingCount.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void jade::ThreadPool::_WorkerLoop(size_t workerIndex) {
+	g_CurrentPool   = this;
+	g_CurrentWorker = workerIndex;
+	JADE_TRACE_THREAD("ThreadPool worker");
+
+	while (true) {
+		Job job;
+		if (_TryPop(workerIndex, job)) {
+			job();
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		if (m_stopping.load(std::memory_order_relaxed) && m_pendingCount.load(std::memory_order_acquire) == 0) {
+			return;
+		}
+		m_sleepCondition.wait(lock, [this]() {
+			return m_stopping.load(std::memory_order_relaxed) || m_pendingCount.load(std::memory_order_acquire) != 0;
+		});
+	}
+}
\ No newline at end of file
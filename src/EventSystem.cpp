@@ -1,51 +1,140 @@
 #include <jade/EventSystem.h>
+#include <jade/Profiler.h>
+#include <jade/Trace.h>
 
 #include <stdexcept>
 
-jade::EventSystem::MemoryStorage::MemoryStorage(size_t bytes) {
-	m_storage = (std::byte*)::operator new (bytes);
-	m_allocated = bytes;
+jade::EventSystem::MemoryStorage::MemoryStorage(size_t chunkBytes) {
+	Allocate(chunkBytes);
 }
 
 jade::EventSystem::MemoryStorage::~MemoryStorage() {
 	Deallocate();
 }
 
-void jade::EventSystem::MemoryStorage::Allocate(size_t bytes) {
-	if (bytes <= m_allocated) {
+void jade::EventSystem::MemoryStorage::Allocate(size_t chunkBytes) {
+	if (chunkBytes == m_chunkBytes && !m_chunks.empty()) {
 		return;
 	}
 	Deallocate();
 
-	m_storage = (std::byte*)::operator new (bytes);
-	m_allocated = bytes;
+	m_chunkBytes = chunkBytes;
+	m_chunks.push_back((std::byte*)::operator new (chunkBytes, std::align_val_t(alignof(std::max_align_t))));
 }
 
 void jade::EventSystem::MemoryStorage::Deallocate() {
-	if (m_allocated > 0) {
-		::operator delete (m_storage, m_allocated);
-		m_allocated = 0;
+	for (std::byte* chunk : m_chunks) {
+		::operator delete (chunk, m_chunkBytes, std::align_val_t(alignof(std::max_align_t)));
 	}
-	m_storage = nullptr;
+	m_chunks.clear();
+	m_chunkIndex = m_chunkOffset = 0;
+}
+
+void* jade::EventSystem::MemoryStorage::_Reserve(size_t bytes, size_t alignment) {
+	if (bytes > m_chunkBytes) {
+		throw std::bad_alloc();
+	}
+	size_t offset = (m_chunkOffset + alignment - 1) & ~(alignment - 1);
+
+	if (m_chunks.empty() || offset + bytes > m_chunkBytes) {
+		if (!m_chunks.empty()) {
+			++m_chunkIndex;
+		}
+		if (m_chunkIndex == m_chunks.size()) {
+			m_chunks.push_back((std::byte*)::operator new (m_chunkBytes, std::align_val_t(alignof(std::max_align_t))));
+		}
+		offset = 0;
+	}
+	m_chunkOffset = offset + bytes;
+	return m_chunks[m_chunkIndex] + offset;
+}
+
+jade::EventSystem::ConcurrentQueue::ConcurrentQueue(size_t capacity) {
+	if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+		throw std::invalid_argument("EventSystem concurrent queue capacity must be a power of two");
+	}
+	m_mask = capacity - 1;
+	m_cells = std::make_unique<_Cell[]>(capacity);
+
+	for (size_t i = 0; i < capacity; ++i) {
+		m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+jade::EventSystem::ConcurrentQueue::~ConcurrentQueue() {
+	for (;;) {
+		_Cell& cell = m_cells[m_dequeuePosition & m_mask];
+		if (cell.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1) {
+			break;
+		}
+		cell.relay(nullptr, cell.data);
+		cell.sequence.store(m_dequeuePosition + m_mask + 1, std::memory_order_release);
+		++m_dequeuePosition;
+	}
+	for (_SpilledEvent& event : m_spilledEvents) {
+		event.relay(nullptr, event.data);
+	}
+}
+
+size_t jade::EventSystem::ConcurrentQueue::Drain(EventSystem& system) {
+	size_t drained = 0;
+	for (;;) {
+		_Cell& cell = m_cells[m_dequeuePosition & m_mask];
+		if (cell.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1) {
+			break;
+		}
+		cell.relay(&system, cell.data);
+		cell.sequence.store(m_dequeuePosition + m_mask + 1, std::memory_order_release);
+
+		++m_dequeuePosition;
+		++drained;
+	}
+	// A claimed cell that is not published yet may hold an event its producer pushed
+	// before spilling, so the spill waits for the next Dispatch. New pushes go to the
+	// spill once it started, the producer of that cell wakes the main thread.
+	bool isRingDrained = m_enqueuePosition.load(std::memory_order_acquire) == m_dequeuePosition;
+	if (isRingDrained && m_spilling.load(std::memory_order_acquire)) {
+		std::lock_guard<std::mutex> lock(m_spillMutex);
+		for (_SpilledEvent& event : m_spilledEvents) {
+			event.relay(&system, event.data);
+		}
+		drained += m_spilledEvents.size();
+
+		m_spilledEvents.clear();
+		m_spillData.Reset();
+		m_spilling.store(false, std::memory_order_release);
+	}
+	return drained;
 }
 
 namespace {
 	jade::EventSystem* g_EventSystem = nullptr;
 }
 
-jade::EventSystem::EventSystem() : m_eventQueue() {
+jade::EventSystem::EventSystem() {
 	if (g_EventSystem != nullptr) {
 		throw std::runtime_error("EventSystem is already created");
 	}
-	m_eventsData.Allocate(s_QueueSize * s_MaxEventDataBytes);
+	m_eventsData.Allocate(s_StorageChunkBytes);
+	m_eventQueue.reserve(s_QueueSize);
 
-	m_subscriberTable.resize(128);
-	m_dispatchers.reserve(128);
+	m_mainThreadId = std::this_thread::get_id();
 
+	Subscribe<OnCoroutineResume>(0, [](OnCoroutineResume& e) {
+		std::exchange(e.handle, nullptr).resume();
+	});
 	g_EventSystem = this;
 }
 
 jade::EventSystem::~EventSystem() {
+	// Events that were never dispatched still own their payloads, e.g. the handle of
+	// a suspended coroutine
+	for (size_t i = m_dispatchedCount; i < m_eventQueue.size(); ++i) {
+		const _QueuedEvent& event = m_eventQueue[i];
+		if (_PayloadDestructor destructor = s_PayloadDestructors[event.id]; destructor && event.data) {
+			destructor(event.data);
+		}
+	}
 	g_EventSystem = nullptr;
 }
 
@@ -57,12 +146,67 @@ const jade::EventSystem& jade::EventSystem::GetConst() noexcept {
 	return *g_EventSystem;
 }
 
+void jade::EventSystem::Update(Timestep deltaTime) {
+	m_elapsedTime += deltaTime;
+	m_timerWheel.Advance((uint64_t)(m_elapsedTime.Seconds() * 1000.0));
+}
+
+jade::Timestep jade::EventSystem::GetTimeUntilNextTimer() const noexcept {
+	uint64_t nextTick = m_timerWheel.GetNextEventTick();
+	if (nextTick == TimerWheel::s_NoTick) {
+		return -1.0;
+	}
+	uint64_t currentTick = m_timerWheel.GetCurrentTick();
+	return nextTick <= currentTick ? 0.0 : (double)(nextTick - currentTick) * 0.001;
+}
+
 void jade::EventSystem::Dispatch() {
-	while (m_eventQueueHead < m_eventQueueTail) {
-		uint32_t eventId = m_eventQueue[m_eventQueueHead];
-		m_dispatchers[eventId]();
-		++m_eventQueueHead;
+	JADE_TRACE_SCOPE("EventSystem::Dispatch");
+	m_wakeupRequested.exchange(false, std::memory_order_acq_rel);
+	m_concurrentQueue.Drain(*this);
+
+	size_t i = 0;
+	while (i < m_eventQueue.size()) {
+		_QueuedEvent first = m_eventQueue[i];
+		size_t payloadSize = s_PayloadSizes[first.id];
+		size_t count = 1;
+
+		while (i + count < m_eventQueue.size()) {
+			const _QueuedEvent& next = m_eventQueue[i + count];
+			if (next.id != first.id || (std::byte*)next.data != (std::byte*)first.data + count * payloadSize) {
+				break;
+			}
+			++count;
+		}
+		m_dispatchedCount = i + count;
+
+		JADE_PROFILE_EVENT(first.id);
+		for (const _Subscriber& subscriber : m_subscriberTable[first.id]) {
+			subscriber.function(first.data, count);
+		}
+		if (_PayloadDestructor destructor = s_PayloadDestructors[first.id]) {
+			for (size_t j = 0; j < count; ++j) {
+				destructor((std::byte*)first.data + j * payloadSize);
+			}
+		}
+		i += count;
 	}
+	size_t eventCount = m_eventQueue.size();
+
+	m_metrics.dispatched += eventCount;
+	m_metrics.peakQueueDepth = std::max(m_metrics.peakQueueDepth, eventCount);
+
+	m_eventQueue.clear();
 	m_eventsData.Reset();
-	m_eventQueueHead = m_eventQueueTail = 0;
+	m_dispatchedCount = 0;
+}
+
+jade::EventSystem::Metrics jade::EventSystem::GetMetrics() const noexcept {
+	Metrics metrics = m_metrics;
+	metrics.spilled      = m_concurrentQueue.GetSpilledCount();
+	metrics.blocked      = m_concurrentQueue.GetBlockedCount();
+	metrics.coalesced   += m_concurrentQueue.GetCoalescedCount();
+	metrics.dropped      = m_concurrentQueue.GetDroppedCount();
+	metrics.storageBytes = m_eventsData.GetAllocatedBytes();
+	return metrics;
 }
\ No newline at end of file
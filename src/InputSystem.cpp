@@ -5,7 +5,8 @@
 #include <stdexcept>
 
 namespace {
-	jade::Key ConvertNativeKeyCode(int code) noexcept;
+	void NativeInit();
+	void NativeShutdown() noexcept;
 	void NativeUpdate(jade::InputSystem::UpdateContext&);
 }
 
@@ -13,7 +14,7 @@ namespace {
 	jade::InputSystem* g_InputSystem = nullptr;
 }
 
-jade::InputSystem::InputSystem() : m_keyPressedState(512) {
+jade::InputSystem::InputSystem() {
 	if (g_InputSystem != nullptr) {
 		throw std::runtime_error("Attempt to create input system twice");
 	}
@@ -21,6 +22,9 @@ jade::InputSystem::InputSystem() : m_keyPressedState(512) {
 }
 
 jade::InputSystem::~InputSystem() {
+	if (m_isEnabled) {
+		NativeShutdown();
+	}
 	g_InputSystem = nullptr;
 }
 
@@ -55,6 +59,9 @@ char jade::InputSystem::KeyToChar(Key key, KeyModifier mods) const noexcept {
 				case Key::N8: return '*';
 				case Key::N9: return '(';
 				case Key::N0: return ')';
+
+				// Only the digit keys get here
+				default: break;
 			}
 		}
 		return (char)('0' + ((int)key - (int)Key::N0));
@@ -66,21 +73,48 @@ char jade::InputSystem::KeyToChar(Key key, KeyModifier mods) const noexcept {
 		case Key::Quote: return hasShift ? '"' : '\'';
 		case Key::Comma: return hasShift ? '<' : ',';
 		case Key::Dot:   return hasShift ? '>' : '.';
+
+		// Control, modifier and function keys have no character
+		default: break;
 	}
 	return '\0';
 }
 
+void jade::InputSystem::Enable() {
+	if (m_isEnabled) {
+		return;
+	}
+	NativeInit();
+	m_isEnabled = true;
+}
+
 void jade::InputSystem::Update(Timestep deltaTime) {
+	if (!m_isEnabled) {
+		return;
+	}
 	UpdateContext ctx = {
-		.deltaTime    = deltaTime,
-		.keyPressedState = m_keyPressedState
+		.deltaTime   = deltaTime,
+		.pressedKeys = m_pressedKeys,
+		.heldKeys    = m_heldKeys
 	};
 	NativeUpdate(ctx);
 }
 
+jade::Timestep jade::InputSystem::GetTimeUntilNextRepeat() const noexcept {
+	Timestep nextRepeat = -1.0;
+	for (const HeldKey& held : m_heldKeys) {
+		if (nextRepeat < 0.0 || held.delay < nextRepeat) {
+			nextRepeat = held.delay;
+		}
+	}
+	return nextRepeat;
+}
+
 #if defined(_WIN32) || defined(WIN32)
 #include <Windows.h>
 
+#include <bit>
+
 namespace {
 	jade::Key ConvertNativeKeyCode(int code) noexcept {
 		if (code >= (int)'A' && code <= (int)'Z') {
@@ -117,59 +151,393 @@ namespace {
 		return jade::Key::None;
 	}
 
+	constexpr double s_RepeatDelay    = 0.45;
+	constexpr double s_RepeatInterval = 1.0 / 30.0;
+
+	void NativeInit() {}
+	void NativeShutdown() noexcept {}
+
+	bool IsKeyDown(const jade::InputSystem::KeyBits& bits, int code) noexcept {
+		return (bits[code / 64] >> (code % 64)) & 1;
+	}
+
+	jade::KeyModifier GetModifiers(const jade::InputSystem::KeyBits& bits) noexcept {
+		jade::KeyModifier mods = jade::KeyModifier::None;
+
+		if (IsKeyDown(bits, VK_LSHIFT)) {
+			mods = mods | jade::KeyModifier::LShift | jade::KeyModifier::Shift;
+		}
+		if (IsKeyDown(bits, VK_RSHIFT)) {
+			mods = mods | jade::KeyModifier::RShift | jade::KeyModifier::Shift;
+		}
+		if (IsKeyDown(bits, VK_LCONTROL)) {
+			mods = mods | jade::KeyModifier::LCtrl | jade::KeyModifier::Ctrl;
+		}
+		if (IsKeyDown(bits, VK_RCONTROL)) {
+			mods = mods | jade::KeyModifier::RCtrl | jade::KeyModifier::Ctrl;
+		}
+		if (IsKeyDown(bits, VK_LMENU)) {
+			mods = mods | jade::KeyModifier::LAlt | jade::KeyModifier::Alt;
+		}
+		if (IsKeyDown(bits, VK_RMENU)) {
+			mods = mods | jade::KeyModifier::RAlt | jade::KeyModifier::Alt;
+		}
+		return mods;
+	}
+
+	// Sampling every key is the only way to read the async key state, everything
+	// after it only touches the keys that changed or are held
 	void NativeUpdate(jade::InputSystem::UpdateContext& ctx) {
+		// Keys held while the window loses focus would keep the repeat timeout at zero
 		if (!jade::IsConsoleWindowFocused()) {
+			ctx.heldKeys.clear();
 			return;
 		}
-		std::vector<jade::InputSystem::KeyState> newState = ctx.keyPressedState;
+		jade::InputSystem::KeyBits current = {};
+		for (int vk = 0; vk < (int)jade::InputSystem::s_NativeKeyCount; ++vk) {
+			if (GetAsyncKeyState(vk) & 0x8000) {
+				current[vk / 64] |= 1ull << (vk % 64);
+			}
+		}
+
+		for (jade::InputSystem::HeldKey& held : ctx.heldKeys) {
+			if (!IsKeyDown(current, held.code)) {
+				continue;
+			}
+			if (ctx.deltaTime >= held.delay) {
+				held.delay = s_RepeatInterval;
+				g_InputSystem->GenerateKeyPressed(ConvertNativeKeyCode(held.code), true, held.mods);
+			}
+			else {
+				held.delay -= ctx.deltaTime;
+			}
+		}
+
+		jade::KeyModifier mods = GetModifiers(current);
+		for (size_t word = 0; word < current.size(); ++word) {
+			uint64_t changed = current[word] ^ ctx.pressedKeys[word];
 
-		for (int vk = 0; vk < 256; ++vk) {
-			bool isPressed = (GetAsyncKeyState(vk) & 0x8000) != 0;
-			bool wasPressed = ctx.keyPressedState[vk].pressed;
+			while (changed != 0) {
+				int vk = (int)(word * 64) + std::countr_zero(changed);
+				changed &= changed - 1;
 
-			if (isPressed != wasPressed) {
 				jade::Key key = ConvertNativeKeyCode(vk);
 				if (key == jade::Key::None) {
 					continue;
 				}
-				jade::KeyModifier mods = jade::KeyModifier::None;
+				bool isPressed = IsKeyDown(current, vk);
+				g_InputSystem->GenerateKeyPressed(key, isPressed, mods);
 
-				if (GetAsyncKeyState(VK_LSHIFT) & 0x8000) {
-					mods = mods | jade::KeyModifier::LShift | jade::KeyModifier::Shift;
-				}
-				if (GetAsyncKeyState(VK_RSHIFT) & 0x8000) {
-					mods = mods | jade::KeyModifier::RShift | jade::KeyModifier::Shift;
+				if (isPressed) {
+					ctx.heldKeys.push_back(jade::InputSystem::HeldKey{
+						.code  = vk,
+						.mods  = mods,
+						.delay = s_RepeatDelay
+					});
 				}
-				if (GetAsyncKeyState(VK_LCONTROL) & 0x8000) {
-					mods = mods | jade::KeyModifier::LCtrl | jade::KeyModifier::Ctrl;
-				}
-				if (GetAsyncKeyState(VK_RCONTROL) & 0x8000) {
-					mods = mods | jade::KeyModifier::RCtrl | jade::KeyModifier::Ctrl;
-				}
-				if (GetAsyncKeyState(VK_LMENU) & 0x8000) {
-					mods = mods | jade::KeyModifier::LAlt | jade::KeyModifier::Alt;
-				}
-				if (GetAsyncKeyState(VK_RMENU) & 0x8000) {
-					mods = mods | jade::KeyModifier::RAlt | jade::KeyModifier::Alt;
+				else {
+					std::erase_if(ctx.heldKeys, [vk](const jade::InputSystem::HeldKey& held) {
+						return held.code == vk;
+					});
 				}
-				g_InputSystem->GenerateKeyPressed(key, isPressed, mods);
+			}
+		}
+		ctx.pressedKeys = current;
+	}
+}
+#else
+#include <termios.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <string>
+#include <cerrno>
+#include <cstdlib>
+
+namespace {
+	constexpr int s_EscapeTimeoutMs = 25;
+
+	termios g_OriginalTerminal = {};
+	bool    g_IsRawMode = false;
+	bool    g_IsInputClosed = false;
+
+	struct DecodedKey {
+		jade::Key         key  = jade::Key::None;
+		jade::KeyModifier mods = jade::KeyModifier::None;
+	};
+
+	void RestoreTerminal() noexcept {
+		if (g_IsRawMode) {
+			tcsetattr(STDIN_FILENO, TCSAFLUSH, &g_OriginalTerminal);
+			g_IsRawMode = false;
+		}
+	}
+
+	void RestoreTerminalOnSignal(int signal) {
+		RestoreTerminal();
+		::signal(signal, SIG_DFL);
+		raise(signal);
+	}
+
+	jade::KeyModifier ShiftModifiers() noexcept { return jade::KeyModifier::LShift | jade::KeyModifier::Shift; }
+	jade::KeyModifier CtrlModifiers() noexcept { return jade::KeyModifier::LCtrl | jade::KeyModifier::Ctrl; }
+	jade::KeyModifier AltModifiers() noexcept { return jade::KeyModifier::LAlt | jade::KeyModifier::Alt; }
+
+	// xterm encodes modifiers as 1 + (shift | alt << 1 | ctrl << 2)
+	jade::KeyModifier ConvertXtermModifiers(int code) noexcept {
+		jade::KeyModifier mods = jade::KeyModifier::None;
+		int bits = code > 1 ? code - 1 : 0;
+
+		if (bits & 0x1) {
+			mods = mods | ShiftModifiers();
+		}
+		if (bits & 0x2) {
+			mods = mods | AltModifiers();
+		}
+		if (bits & 0x4) {
+			mods = mods | CtrlModifiers();
+		}
+		return mods;
+	}
 
-				newState[vk].pressed = isPressed;
-				newState[vk].mods    = mods;
-				newState[vk].delay   = 0.45;
+	DecodedKey ConvertChar(unsigned char c) noexcept {
+		if (c >= 'a' && c <= 'z') {
+			return { (jade::Key)((int)jade::Key::A + (c - 'a')), jade::KeyModifier::None };
+		}
+		if (c >= 'A' && c <= 'Z') {
+			return { (jade::Key)((int)jade::Key::A + (c - 'A')), ShiftModifiers() };
+		}
+		if (c >= '0' && c <= '9') {
+			return { (jade::Key)((int)jade::Key::N0 + (c - '0')), jade::KeyModifier::None };
+		}
+		switch (c) {
+			case '\r':
+			case '\n': return { jade::Key::Enter };
+			case '\t': return { jade::Key::Tab };
+			case 0x7f:
+			case 0x08: return { jade::Key::Backspace };
+			case 0x1b: return { jade::Key::Escape };
+			case ' ':  return { jade::Key::Space };
+
+			case '!': return { jade::Key::N1, ShiftModifiers() };
+			case '@': return { jade::Key::N2, ShiftModifiers() };
+			case '#': return { jade::Key::N3, ShiftModifiers() };
+			case '$': return { jade::Key::N4, ShiftModifiers() };
+			case '%': return { jade::Key::N5, ShiftModifiers() };
+			case '^': return { jade::Key::N6, ShiftModifiers() };
+			case '&': return { jade::Key::N7, ShiftModifiers() };
+			case '*': return { jade::Key::N8, ShiftModifiers() };
+			case '(': return { jade::Key::N9, ShiftModifiers() };
+			case ')': return { jade::Key::N0, ShiftModifiers() };
+
+			case '-':  return { jade::Key::Minus };
+			case '_':  return { jade::Key::Minus, ShiftModifiers() };
+			case ';':  return { jade::Key::Colon };
+			case ':':  return { jade::Key::Colon, ShiftModifiers() };
+			case '\'': return { jade::Key::Quote };
+			case '"':  return { jade::Key::Quote, ShiftModifiers() };
+			case ',':  return { jade::Key::Comma };
+			case '<':  return { jade::Key::Comma, ShiftModifiers() };
+			case '.':  return { jade::Key::Dot };
+			case '>':  return { jade::Key::Dot, ShiftModifiers() };
+		}
+		if (c >= 0x01 && c <= 0x1a) {
+			return { (jade::Key)((int)jade::Key::A + (c - 0x01)), CtrlModifiers() };
+		}
+		return {};
+	}
+
+	jade::Key ConvertFunctionKey(int code) noexcept {
+		switch (code) {
+			case 11: return jade::Key::F1;
+			case 12: return jade::Key::F2;
+			case 13: return jade::Key::F3;
+			case 14: return jade::Key::F4;
+			case 15: return jade::Key::F5;
+			case 17: return jade::Key::F6;
+			case 18: return jade::Key::F7;
+			case 19: return jade::Key::F8;
+			case 20: return jade::Key::F9;
+			case 21: return jade::Key::F10;
+			case 23: return jade::Key::F11;
+			case 24: return jade::Key::F12;
+		}
+		return jade::Key::None;
+	}
+
+	jade::Key ConvertFinalByte(unsigned char c) noexcept {
+		switch (c) {
+			case 'A': return jade::Key::Up;
+			case 'B': return jade::Key::Down;
+			case 'C': return jade::Key::Right;
+			case 'D': return jade::Key::Left;
+			case 'P': return jade::Key::F1;
+			case 'Q': return jade::Key::F2;
+			case 'R': return jade::Key::F3;
+			case 'S': return jade::Key::F4;
+		}
+		return jade::Key::None;
+	}
+
+	// Decodes one key starting at 'position'. Returns the number of bytes consumed,
+	// 0 if the buffer ends in the middle of an escape sequence.
+	size_t DecodeKey(const std::string& input, size_t position, DecodedKey& decoded) noexcept {
+		unsigned char first = (unsigned char)input[position];
+
+		if (first != 0x1b) {
+			decoded = ConvertChar(first);
+			// Terminals send "\r\n" for Enter in some modes, it is a single key press
+			if (first == '\r' && position + 1 < input.size() && input[position + 1] == '\n') {
+				return 2;
+			}
+			return 1;
+		}
+		if (position + 1 >= input.size()) {
+			return 0;
+		}
+		unsigned char introducer = (unsigned char)input[position + 1];
+
+		// SS3: ESC O <final>
+		if (introducer == 'O') {
+			if (position + 2 >= input.size()) {
+				return 0;
 			}
-			else if (wasPressed) {
-				if (ctx.deltaTime >= ctx.keyPressedState[vk].delay) {
-					newState[vk].delay = 0.0;
-					jade::Key key = ConvertNativeKeyCode(vk);
-					g_InputSystem->GenerateKeyPressed(key, isPressed, ctx.keyPressedState[vk].mods);
+			decoded = { ConvertFinalByte((unsigned char)input[position + 2]) };
+			return 3;
+		}
+		if (introducer == 0x1b) {
+			decoded = { jade::Key::Escape };
+			return 1;
+		}
+		// Alt+<char> is sent as ESC <char>
+		if (introducer != '[') {
+			decoded = ConvertChar(introducer);
+			decoded.mods = decoded.mods | AltModifiers();
+			return 2;
+		}
+		// CSI: ESC [ <params> <final>
+		int params[2] = { 0, 0 };
+		int paramIndex = 0;
+
+		for (size_t i = position + 2; i < input.size(); ++i) {
+			unsigned char c = (unsigned char)input[i];
+
+			if (c >= '0' && c <= '9') {
+				if (paramIndex < 2) {
+					params[paramIndex] = params[paramIndex] * 10 + (c - '0');
 				}
-				else {
-					newState[vk].delay -= ctx.deltaTime;
+				continue;
+			}
+			if (c == ';') {
+				++paramIndex;
+				continue;
+			}
+			if (c >= 0x40 && c <= 0x7e) {
+				jade::Key key = c == '~' ? ConvertFunctionKey(params[0]) : ConvertFinalByte(c);
+				decoded = { key, ConvertXtermModifiers(params[1]) };
+				return i - position + 1;
+			}
+			// Malformed sequence, drop what was read so far
+			decoded = {};
+			return i - position + 1;
+		}
+		return 0;
+	}
+
+	// Reads everything that is available right now, false once stdin is closed
+	bool ReadAvailable(std::string& input, int timeoutMs) {
+		pollfd fd = { .fd = STDIN_FILENO, .events = POLLIN, .revents = 0 };
+		if (poll(&fd, 1, timeoutMs) <= 0) {
+			return true;
+		}
+		if (!(fd.revents & POLLIN) && (fd.revents & (POLLHUP | POLLERR | POLLNVAL))) {
+			return false;
+		}
+		char buffer[256];
+		while (true) {
+			ssize_t readBytes = read(STDIN_FILENO, buffer, sizeof(buffer));
+			if (readBytes > 0) {
+				input.append(buffer, (size_t)readBytes);
+				if ((size_t)readBytes < sizeof(buffer)) {
+					return true;
+				}
+				continue;
+			}
+			if (readBytes == 0) {
+				return false;
+			}
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+	}
+
+	void NativeInit() {
+		if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &g_OriginalTerminal) != 0) {
+			fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+			return;
+		}
+		termios raw = g_OriginalTerminal;
+
+		// Signals stay enabled so Ctrl+C still terminates, output processing is kept
+		// so '\n' keeps moving to the start of the next line
+		raw.c_iflag &= ~(ICRNL | IXON | BRKINT | INPCK | ISTRIP);
+		raw.c_lflag &= ~(ICANON | ECHO | IEXTEN);
+		raw.c_cflag |= CS8;
+		raw.c_cc[VMIN]  = 0;
+		raw.c_cc[VTIME] = 0;
+
+		if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) {
+			return;
+		}
+		g_IsRawMode = true;
+		fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+
+		static bool isCleanupRegistered = false;
+		if (!isCleanupRegistered) {
+			std::atexit(RestoreTerminal);
+			::signal(SIGINT, RestoreTerminalOnSignal);
+			::signal(SIGTERM, RestoreTerminalOnSignal);
+			::signal(SIGHUP, RestoreTerminalOnSignal);
+			isCleanupRegistered = true;
+		}
+	}
+
+	void NativeShutdown() noexcept {
+		RestoreTerminal();
+	}
+
+	// Terminals only report key presses and repeat held keys themselves, so no key
+	// is ever marked as held and nothing is synthesized from the repeat timers
+	void NativeUpdate(jade::InputSystem::UpdateContext&) {
+		if (g_IsInputClosed) {
+			return;
+		}
+		std::string input;
+		if (!ReadAvailable(input, 0)) {
+			g_IsInputClosed = true;
+			jade::SetConsoleInputClosed();
+		}
+		size_t position = 0;
+		while (position < input.size()) {
+			DecodedKey decoded;
+			size_t consumed = DecodeKey(input, position, decoded);
+
+			if (consumed == 0) {
+				// The rest of an escape sequence is normally written together with its
+				// start, a lone ESC that is not followed in time is the Escape key
+				size_t size = input.size();
+				if (!g_IsInputClosed && ReadAvailable(input, s_EscapeTimeoutMs) && input.size() > size) {
+					continue;
 				}
+				decoded = { jade::Key::Escape };
+				consumed = input.size() - position;
+			}
+			if (decoded.key != jade::Key::None) {
+				g_InputSystem->GenerateKeyPressed(decoded.key, true, decoded.mods);
 			}
+			position += consumed;
 		}
-		ctx.keyPressedState = std::move(newState);
 	}
 }
 #endif // WIN32
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include <jade/backend/LibraryView.h>
+
+#include <algorithm>
+
+void jade::LibraryView::Open(const MusicLibraryProxy& library, SortKey key, bool descending, size_t pageSize, size_t page) {
+	m_tracks.clear();
+	m_next = library.TrackIteratorBegin();
+	m_end  = library.TrackIteratorEnd();
+
+	m_sortKey      = key;
+	m_descending   = descending;
+	m_isOpen       = true;
+	m_page         = page;
+	m_pageSize     = std::clamp<size_t>(pageSize, 1, s_MaxPageSize);
+	m_orderedCount = 0;
+}
+
+bool jade::LibraryView::Update() {
+	for (size_t i = 0; i < s_IndexChunkSize && m_next != m_end; ++i, ++m_next) {
+		m_tracks.push_back(m_next);
+	}
+	if (m_next != m_end) {
+		return false;
+	}
+	// The track map is ordered by ID, which already is the final order
+	if (m_sortKey == SortKey::ID) {
+		if (m_descending && m_orderedCount == 0) {
+			std::reverse(m_tracks.begin(), m_tracks.end());
+		}
+		m_orderedCount = m_tracks.size();
+	}
+	SetPage(m_page);
+	return true;
+}
+
+void jade::LibraryView::SetPage(size_t page) noexcept {
+	size_t pageCount = GetPageCount();
+	m_page = pageCount == 0 ? 0 : std::min(page, pageCount - 1);
+}
+
+std::span<const jade::MusicLibrary::TrackIterator> jade::LibraryView::GetVisibleTracks() {
+	size_t begin = std::min(m_page * m_pageSize, m_tracks.size());
+	size_t end   = std::min(begin + m_pageSize, m_tracks.size());
+
+	// Selects the tracks up to the end of the page out of the unordered rest, so
+	// paging forward costs a linear pass instead of a full sort
+	if (end > m_orderedCount) {
+		auto less = [this](const auto& left, const auto& right) { return _Less(left, right); };
+		auto first = m_tracks.begin() + m_orderedCount;
+		auto last  = m_tracks.begin() + end;
+
+		std::nth_element(first, last - 1, m_tracks.end(), less);
+		std::sort(first, last, less);
+		m_orderedCount = end;
+	}
+	return std::span<const MusicLibrary::TrackIterator>(m_tracks.data() + begin, end - begin);
+}
+
+bool jade::LibraryView::_Less(const MusicLibrary::TrackIterator& left, const MusicLibrary::TrackIterator& right) const {
+	const MusicLibrary::TrackElement& a = m_descending ? right->second : left->second;
+	const MusicLibrary::TrackElement& b = m_descending ? left->second : right->second;
+
+	switch (m_sortKey) {
+		// Every key falls back to the id below
+		case SortKey::ID:
+			break;
+
+		case SortKey::Name: {
+			int order = a.name.compare(b.name);
+			if (order != 0) {
+				return order < 0;
+			}
+			break;
+		}
+		case SortKey::Artist: {
+			static const std::string s_Empty;
+			const std::string& artistA = a.artists.empty() ? s_Empty : a.artists.front();
+			const std::string& artistB = b.artists.empty() ? s_Empty : b.artists.front();
+
+			int order = artistA.compare(artistB);
+			if (order != 0) {
+				return order < 0;
+			}
+			order = a.name.compare(b.name);
+			if (order != 0) {
+				return order < 0;
+			}
+			break;
+		}
+		case SortKey::Duration:
+			if (a.seconds != b.seconds) {
+				return a.seconds < b.seconds;
+			}
+			break;
+	}
+	return a.id < b.id;
+}
\ No newline at end of file
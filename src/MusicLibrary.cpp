@@ -1,8 +1,14 @@
 #include <jade/MusicLibrary.h>
 #include <jade/audio/Audio.h>
 #include <jade/App.h>
+#include <jade/Trace.h>
+#include <jade/TaskGraph.h>
+#include <jade/AsyncTask.h>
 
+#include <cctype>
+#include <algorithm>
 #include <stdexcept>
+#include <unordered_set>
 
 template <typename T>
 struct ObjectSerializer {
@@ -193,6 +199,9 @@ namespace {
 namespace {
 	void TryOpenFile(std::fstream& file, const char* path);
 	std::string ReadFileContents(std::fstream& file);
+
+	bool IsAudioFile(const std::filesystem::path& path);
+	uint64_t HashFileContents(const std::filesystem::path& path, const jade::CancellationToken& token);
 }
 
 jade::MusicLibrary::MusicLibrary() {
@@ -206,6 +215,9 @@ jade::MusicLibrary::MusicLibrary() {
 			const char* source = readContents.c_str();
 			m_tracks = std::move(ObjectDeserializer<decltype(m_tracks)>()(source));
 		}
+		for (const auto& [id, track] : m_tracks) {
+			_IndexTrack(track);
+		}
 	}
 	TryOpenFile(m_playlistMetadataFile, Config::Paths::MusicPlaylistFile);
 	{
@@ -235,36 +247,8 @@ jade::MusicLibrary::~MusicLibrary() {
 jade::MusicLibrary& jade::MusicLibrary::Get() { return *g_Database; }
 const jade::MusicLibrary& jade::MusicLibrary::GetConst() { return *g_Database; }
 
-std::future<void> jade::MusicLibrary::SaveChanges() {
-	return std::async(std::launch::async, [this]() -> void {
-		if (m_changeStates == 0) {
-			EventEmitter<OnAsyncTaskEnded>().Emit(OnAsyncTaskEnded{
-				.status   = OnTaskEnded::Status::Success,
-				.whatTask = TaskType::AsyncMusicLibrarySave,
-				.category = TaskCategory::Async,
-				.task     = {},
-				.errorMsg = {}
-			});
-			return;
-		}
-		if (m_changeStates & ChangeState::TrackListChangeBit) {
-			m_tracksMetadataFile.seekp(0, std::ios::beg);
-			ObjectSerializer<decltype(m_tracks)>()(m_tracksMetadataFile, m_tracks);
-			m_changeStates &= ~ChangeState::TrackListChangeBit;
-		}
-		if (m_changeStates & ChangeState::PlaylistChangeBit) {
-			m_playlistMetadataFile.seekp(0, std::ios::beg);
-			ObjectSerializer<decltype(m_playlists)>()(m_playlistMetadataFile, m_playlists);
-			m_changeStates &= ~ChangeState::PlaylistChangeBit;
-		}
-		EventEmitter<OnAsyncTaskEnded>().Emit(OnAsyncTaskEnded{
-			.status   = OnTaskEnded::Status::Success,
-			.whatTask = TaskType::AsyncMusicLibrarySave,
-			.category = TaskCategory::Async,
-			.task     = {},
-			.errorMsg = {}
-		});
-	});
+std::future<void> jade::MusicLibrary::SaveChanges(const std::shared_ptr<FutureTask>& task) {
+	return Launch(_SaveChangesAsync(), TaskType::AsyncMusicLibrarySave, task);
 }
 
 jade::MusicLibrary::TrackIterator jade::MusicLibrary::GetTrackByID(uint64_t id) const {
@@ -274,88 +258,118 @@ jade::MusicLibrary::TrackIterator jade::MusicLibrary::GetTrackByID(uint64_t id)
 std::future<void> jade::MusicLibrary::Add(
 const std::vector<std::string>& artists, const std::vector<std::string>& feat,
 const std::string& name, const std::filesystem::path& path, const std::shared_ptr<FutureTask>& task) {
-	return std::async(std::launch::async, [=, this]() -> void {
-		auto CheckCancellation = [task]() -> bool {
-			if (task->ShouldCancel()) {
-				EventEmitter<OnAsyncTaskEnded>().Emit(OnAsyncTaskEnded{
-					.status   = OnTaskEnded::Status::Cancelled,
-					.whatTask = TaskType::AsyncMusicLibraryAdd,
-					.category = TaskCategory::Async,
-					.task     = std::move(task),
-					.errorMsg = {}
-				});
-				return true;
+	return Launch(_AddAsync(artists, feat, name, path), TaskType::AsyncMusicLibraryAdd, task);
+}
+
+std::future<void> jade::MusicLibrary::Import(const std::filesystem::path& directory, const std::shared_ptr<FutureTask>& task) {
+	struct ImportedFile {
+		std::filesystem::path source;
+		std::filesystem::path destination;
+		uint64_t              hash        = 0;
+		double                seconds     = 0.0;
+		bool                  isDuplicate = false;
+	};
+	auto files = std::make_shared<std::vector<ImportedFile>>();
+	std::shared_ptr<TaskGraph> graph = TaskGraph::Create(TaskType::AsyncMusicLibraryImport, task);
+
+	TaskGraph::NodeID scan = graph->AddNode("scan", [directory, files](TaskGraph::Context& context) {
+		if (!std::filesystem::is_directory(directory)) {
+			throw std::runtime_error(std::string("Path '") + directory.string() + "' is not a directory");
+		}
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
+			if (context.IsCancelled()) {
+				return;
+			}
+			if (entry.is_regular_file() && IsAudioFile(entry.path())) {
+				files->push_back(ImportedFile{ .source = entry.path(), .destination = {} });
 			}
-			return false;
-		};
-		if (!std::filesystem::exists(path)) {
-			EventEmitter<OnAsyncTaskEnded>().Emit(OnAsyncTaskEnded{
-				.status   = OnTaskEnded::Status::Failed,
-				.whatTask = TaskType::AsyncMusicLibraryAdd,
-				.category = TaskCategory::Async,
-				.task     = std::move(task),
-				.errorMsg = std::string("Path '") + path.string() + "' does not exist in the filesystem"
-			});
-			return;
 		}
-		if (CheckCancellation()) {
-			return;
+		for (ImportedFile& file : *files) {
+			context.AddChild("hash", [&file](TaskGraph::Context& context) {
+				file.hash = HashFileContents(file.source, context.GetCancellationToken());
+			});
 		}
-		std::future<double> trackSeconds = std::async(std::launch::async, [path]() -> double {
-			return Audio::GetTrackLengthSeconds(path.string());
-		});
-		if (CheckCancellation()) {
-			return;
+	}, {}, 1.0f, TaskPriority::High);
+
+	// Duplicates are dropped before anything is copied. Same-named files from different
+	// directories, or already in storage, get a counter suffix instead of overwriting.
+	TaskGraph::NodeID dedup = graph->AddNode("dedup", [files](TaskGraph::Context& context) {
+		std::unordered_set<uint64_t> hashes;
+		std::unordered_set<std::string> destinations;
+		hashes.reserve(files->size());
+		destinations.reserve(files->size());
+
+		for (ImportedFile& file : *files) {
+			if (!hashes.insert(file.hash).second) {
+				file.isDuplicate = true;
+				continue;
+			}
+			const std::filesystem::path storage = Config::Paths::MusicStorage;
+			std::string stem      = file.source.stem().string();
+			std::string extension = file.source.extension().string();
+			std::filesystem::path destination = storage / file.source.filename();
+
+			for (size_t counter = 1;
+				!destinations.insert(destination.string()).second || std::filesystem::exists(destination);
+				++counter) {
+				destination = storage / (stem + " (" + std::to_string(counter) + ")" + extension);
+			}
+			file.destination = std::move(destination);
+
+			context.AddChild("probe", [&file](TaskGraph::Context&) {
+				file.seconds = Audio::GetTrackLengthSeconds(file.source.string());
+			});
+			context.AddChild("copy", [&file](TaskGraph::Context&) {
+				std::filesystem::copy_file(file.source, file.destination);
+			}, {}, 2.0f);
 		}
-		std::filesystem::copy_file(
-			path,
-			Config::Paths::MusicStorage / path.filename(),
-			std::filesystem::copy_options::overwrite_existing
-		);
-		if (CheckCancellation()) {
-			return;
+	}, { scan });
+
+	// Committing on the main thread keeps the track map out of reach of readers mid-insert
+	TaskGraph::NodeID commit = graph->AddMainThreadNode("commit", [this, files](TaskGraph::Context&) {
+		std::lock_guard<std::mutex> lock(m_writeMutex);
+
+		bool isChanged = false;
+		for (ImportedFile& file : *files) {
+			if (file.isDuplicate) {
+				continue;
+			}
+			TrackElement track = {};
+			track.id        = m_tracks.size();
+			track.seconds   = file.seconds;
+			track.name      = file.source.stem().string();
+			track.audioPath = std::move(file.destination);
+			_IndexTrack(track);
+			m_tracks.emplace(track.id, std::move(track));
+			isChanged = true;
 		}
-		TrackElement track = {};
-		track.artists   = artists;
-		track.feat      = feat;
-		track.name      = name;
-		track.id        = m_tracks.size();
-		track.audioPath = Config::Paths::MusicStorage / path.filename();
-
-		if (CheckCancellation()) {
-			return;
+		if (isChanged) {
+			m_changeStates |= ChangeState::TrackListChangeBit;
 		}
-		track.seconds = trackSeconds.get();
+	}, { dedup });
 
-		if (CheckCancellation()) {
-			return;
-		}
-		m_tracks.emplace(track.id, std::move(track));
-		m_changeStates |= ChangeState::TrackListChangeBit;
+	graph->AddNode("save", [this](TaskGraph::Context&) {
+		_WriteChanges();
+	}, { commit });
 
-		EventEmitter<OnAsyncTaskEnded>().Emit(OnAsyncTaskEnded{
-			.status = OnTaskEnded::Status::Success,
-			.whatTask = TaskType::AsyncMusicLibraryAdd,
-			.category = TaskCategory::Async,
-			.task     = std::move(task),
-			.errorMsg = {}
-		});
-	});
+	return graph->Launch();
 }
 
 std::string jade::MusicLibrary::CreatePlaylist(const std::string& name, const std::vector<uint64_t>& ids) {
+	std::lock_guard<std::mutex> lock(m_writeMutex);
+
 	PlaylistElement playlist = {};
 	playlist.seconds = 0;
 
 	std::string error;
 	for (uint64_t id : ids) {
-		if (id >= m_tracks.size()) {
+		auto track = m_tracks.find(id);
+		if (track == m_tracks.end()) {
 			if (error.empty()) error += std::to_string(id);
 			else error += std::string(", ") + std::to_string(id);
 			continue;
 		}
-		TrackElement& track = m_tracks[id];
-		playlist.seconds += track.seconds;
+		playlist.seconds += track->second.seconds;
 		playlist.tracks.emplace_back(id);
 	}
 	playlist.name = name;
@@ -365,7 +379,7 @@ std::string jade::MusicLibrary::CreatePlaylist(const std::string& name, const st
 	m_changeStates |= ChangeState::PlaylistChangeBit;
 
 	if (!error.empty()) {
-		error += " do not exits in music database";
+		error += " do not exist in music database";
 		return error;
 	}
 	return {};
@@ -374,6 +388,87 @@ std::string jade::MusicLibrary::CreatePlaylist(const std::string& name, const st
 jade::MusicLibrary::TrackIterator jade::MusicLibrary::TrackIteratorBegin() const { return m_tracks.cbegin(); }
 jade::MusicLibrary::TrackIterator jade::MusicLibrary::TrackIteratorEnd() const { return m_tracks.cend(); }
 
+jade::RadixTree::Completion jade::MusicLibrary::CompleteName(NameIndex index, std::string_view prefix, size_t maxCandidates) const {
+	std::lock_guard<std::mutex> lock(m_indexMutex);
+	return (index == NameIndex::Tracks ? m_trackNames : m_artistNames).Complete(prefix, maxCandidates);
+}
+
+jade::AsyncTask<void> jade::MusicLibrary::_SaveChangesAsync() {
+	co_await ResumeOnThreadPool();
+
+	JADE_TRACE_SCOPE("MusicLibrary::SaveChanges");
+	_WriteChanges();
+}
+
+jade::AsyncTask<void> jade::MusicLibrary::_AddAsync(
+std::vector<std::string> artists, std::vector<std::string> feat, std::string name, std::filesystem::path path) {
+	co_await ResumeOnThreadPool();
+
+	if (!std::filesystem::exists(path)) {
+		throw std::runtime_error(std::string("Path '") + path.string() + "' does not exist in the filesystem");
+	}
+	std::future<double> trackSeconds = ThreadPool::Get().Submit([path]() -> double {
+		JADE_TRACE_SCOPE("Audio::GetTrackLengthSeconds");
+		return Audio::GetTrackLengthSeconds(path.string());
+	});
+	co_await CancellationCheckpoint();
+	{
+		JADE_TRACE_SCOPE("MusicLibrary::Add copy");
+		std::filesystem::copy_file(
+			path,
+			Config::Paths::MusicStorage / path.filename(),
+			std::filesystem::copy_options::overwrite_existing
+		);
+	}
+	co_await CancellationCheckpoint();
+
+	TrackElement track = {};
+	track.artists   = std::move(artists);
+	track.feat      = std::move(feat);
+	track.name      = std::move(name);
+	track.audioPath = Config::Paths::MusicStorage / path.filename();
+	{
+		JADE_TRACE_SCOPE("MusicLibrary::Add wait probe");
+		track.seconds = ThreadPool::Get().Await(trackSeconds);
+	}
+	// Committing on the main thread keeps the track map out of reach of readers mid-insert
+	co_await ResumeOnMainThread();
+	{
+		std::lock_guard<std::mutex> lock(m_writeMutex);
+		track.id = m_tracks.size();
+		_IndexTrack(track);
+		m_tracks.emplace(track.id, std::move(track));
+		m_changeStates |= ChangeState::TrackListChangeBit;
+	}
+}
+
+void jade::MusicLibrary::_IndexTrack(const TrackElement& track) {
+	std::lock_guard<std::mutex> lock(m_indexMutex);
+
+	m_trackNames.Insert(track.name, track.id);
+	for (const std::string& artist : track.artists) {
+		m_artistNames.Insert(artist);
+	}
+	for (const std::string& artist : track.feat) {
+		m_artistNames.Insert(artist);
+	}
+}
+
+void jade::MusicLibrary::_WriteChanges() {
+	std::lock_guard<std::mutex> lock(m_writeMutex);
+
+	if (m_changeStates & ChangeState::TrackListChangeBit) {
+		m_tracksMetadataFile.seekp(0, std::ios::beg);
+		ObjectSerializer<decltype(m_tracks)>()(m_tracksMetadataFile, m_tracks);
+		m_changeStates &= ~ChangeState::TrackListChangeBit;
+	}
+	if (m_changeStates & ChangeState::PlaylistChangeBit) {
+		m_playlistMetadataFile.seekp(0, std::ios::beg);
+		ObjectSerializer<decltype(m_playlists)>()(m_playlistMetadataFile, m_playlists);
+		m_changeStates &= ~ChangeState::PlaylistChangeBit;
+	}
+}
+
 namespace {
 	void TryOpenFile(std::fstream& file, const char* path) {
 		file.open(path, std::ios::binary | std::ios::in | std::ios::out);
@@ -389,6 +484,42 @@ namespace {
 		}
 	}
 
+	bool IsAudioFile(const std::filesystem::path& path) {
+		static constexpr const char* extensions[] = { ".mp3", ".wav", ".flac", ".ogg" };
+
+		std::string extension = path.extension().string();
+		for (char& c : extension) {
+			c = (char)std::tolower((unsigned char)c);
+		}
+		for (const char* audioExtension : extensions) {
+			if (extension == audioExtension) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// FNV-1a over the whole file, used to skip duplicate files within one import
+	uint64_t HashFileContents(const std::filesystem::path& path, const jade::CancellationToken& token) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open()) {
+			throw std::runtime_error(std::string("Failed to open '") + path.string() + '\'');
+		}
+		uint64_t hash = 14695981039346656037ull;
+		char buffer[64 * 1024];
+
+		while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+			if (token.IsCancelled()) {
+				return hash;
+			}
+			std::streamsize count = file.gcount();
+			for (std::streamsize i = 0; i < count; ++i) {
+				hash = (hash ^ (uint8_t)buffer[i]) * 1099511628211ull;
+			}
+		}
+		return hash;
+	}
+
 	std::string ReadFileContents(std::fstream& file) {
 		std::string buffer;
 
@@ -414,8 +545,8 @@ m_library(library), m_attachments(attachments) {
 	_CreateAttachments(attachments);
 }
 
-std::future<void> jade::MusicLibraryProxy::SaveChanges() {
-	return m_library->SaveChanges();
+std::future<void> jade::MusicLibraryProxy::SaveChanges(const std::shared_ptr<FutureTask>& task) {
+	return m_library->SaveChanges(task);
 }
 
 jade::MusicLibrary::TrackIterator jade::MusicLibraryProxy::GetTrackByID(uint64_t id) const {
@@ -441,6 +572,10 @@ const std::shared_ptr<FutureTask>& task) {
 	return m_library->Add(artists, feat, name, path, task);
 }
 
+std::future<void> jade::MusicLibraryProxy::Import(const std::filesystem::path& directory, const std::shared_ptr<FutureTask>& task) {
+	return m_library->Import(directory, task);
+}
+
 std::string jade::MusicLibraryProxy::CreatePlaylist(const std::string& name, const std::vector<uint64_t>& ids) {
 	return m_library->CreatePlaylist(name, ids);
 }
@@ -0,0 +1,61 @@
+#include <jade/audio/PcmRingBuffer.h>
+
+#include <bit>
+#include <cstring>
+#include <algorithm>
+
+jade::PcmRingBuffer::PcmRingBuffer(size_t capacity) {
+	Reset(capacity);
+}
+
+void jade::PcmRingBuffer::Reset(size_t capacity) {
+	capacity = std::bit_ceil(std::max<size_t>(capacity, 1));
+
+	m_samples = std::make_unique<float[]>(capacity);
+	m_mask = capacity - 1;
+	Clear();
+}
+
+void jade::PcmRingBuffer::Clear() noexcept {
+	m_writePosition.store(0, std::memory_order_relaxed);
+	m_readPosition.store(0, std::memory_order_relaxed);
+}
+
+size_t jade::PcmRingBuffer::Write(const float* samples, size_t count) noexcept {
+	size_t writePosition = m_writePosition.load(std::memory_order_relaxed);
+	size_t readPosition  = m_readPosition.load(std::memory_order_acquire);
+
+	count = std::min(count, GetCapacity() - (writePosition - readPosition));
+	size_t offset    = writePosition & m_mask;
+	size_t firstPart = std::min(count, GetCapacity() - offset);
+
+	std::memcpy(m_samples.get() + offset, samples, firstPart * sizeof(float));
+	std::memcpy(m_samples.get(), samples + firstPart, (count - firstPart) * sizeof(float));
+
+	m_writePosition.store(writePosition + count, std::memory_order_release);
+	return count;
+}
+
+size_t jade::PcmRingBuffer::GetWritable() const noexcept {
+	return GetCapacity() - GetReadable();
+}
+
+size_t jade::PcmRingBuffer::Read(float* samples, size_t count) noexcept {
+	size_t readPosition  = m_readPosition.load(std::memory_order_relaxed);
+	size_t writePosition = m_writePosition.load(std::memory_order_acquire);
+
+	count = std::min(count, writePosition - readPosition);
+	size_t offset    = readPosition & m_mask;
+	size_t firstPart = std::min(count, GetCapacity() - offset);
+
+	std::memcpy(samples, m_samples.get() + offset, firstPart * sizeof(float));
+	std::memcpy(samples + firstPart, m_samples.get(), (count - firstPart) * sizeof(float));
+
+	m_readPosition.store(readPosition + count, std::memory_order_release);
+	return count;
+}
+
+size_t jade::PcmRingBuffer::GetReadable() const noexcept {
+	size_t readPosition = m_readPosition.load(std::memory_order_acquire);
+	return m_writePosition.load(std::memory_order_acquire) - readPosition;
+}
\ No newline at end of file
@@ -7,6 +7,12 @@
 
 namespace {
 	HWND g_ConsoleHandle = NULL;
+	bool g_IsConsoleInputClosed = false;
+
+	HANDLE GetWakeupEvent() {
+		static HANDLE wakeupEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+		return wakeupEvent;
+	}
 
 	HWND GetConsoleWindowHWND() {
 		if (g_ConsoleHandle) {
@@ -49,4 +55,81 @@ std::string jade::GetClipboardTextContent() {
 	return text;
 }
 
+void jade::WakeMainThread() {
+	SetEvent(GetWakeupEvent());
+}
+
+void jade::WaitForMainThreadWakeup(Timestep timeout) {
+	HANDLE handles[2] = { GetWakeupEvent(), GetStdHandle(STD_INPUT_HANDLE) };
+	DWORD milliseconds = timeout.Seconds() < 0.0 ? INFINITE : (DWORD)std::ceil(timeout.Seconds() * 1000.0);
+
+	// Keys are sampled with GetAsyncKeyState, the console input records only serve
+	// as a readiness signal and have to be discarded to not stay signaled
+	DWORD handleCount = g_IsConsoleInputClosed ? 1 : 2;
+	if (WaitForMultipleObjects(handleCount, handles, FALSE, milliseconds) == WAIT_OBJECT_0 + 1) {
+		FlushConsoleInputBuffer(handles[1]);
+	}
+}
+
+void jade::SetConsoleInputClosed() {
+	g_IsConsoleInputClosed = true;
+}
+
+#else
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cmath>
+
+namespace {
+	bool g_IsConsoleInputClosed = false;
+	int  g_ExtraWakeupFd = -1;
+
+	int GetWakeupFd() {
+		static int wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		return wakeupFd;
+	}
+}
+
+bool jade::IsConsoleWindowFocused() {
+	return true;
+}
+
+std::string jade::GetClipboardTextContent() {
+	return {};
+}
+
+void jade::WakeMainThread() {
+	uint64_t value = 1;
+	ssize_t written = write(GetWakeupFd(), &value, sizeof(value));
+	(void)written;
+}
+
+void jade::WaitForMainThreadWakeup(Timestep timeout) {
+	pollfd fds[3] = {
+		{ .fd = GetWakeupFd(), .events = POLLIN, .revents = 0 },
+		{ .fd = g_ExtraWakeupFd, .events = POLLIN, .revents = 0 },
+		{ .fd = STDIN_FILENO,  .events = POLLIN, .revents = 0 }
+	};
+	int milliseconds = timeout.Seconds() < 0.0 ? -1 : (int)std::ceil(timeout.Seconds() * 1000.0);
+
+	// A closed stdin stays readable forever and would turn the wait into a spin,
+	// poll skips the extra entry while its descriptor is negative
+	nfds_t fdCount = g_IsConsoleInputClosed ? 2 : 3;
+	if (poll(fds, fdCount, milliseconds) > 0 && (fds[0].revents & POLLIN)) {
+		uint64_t value = 0;
+		ssize_t readBytes = read(fds[0].fd, &value, sizeof(value));
+		(void)readBytes;
+	}
+}
+
+void jade::SetConsoleInputClosed() {
+	g_IsConsoleInputClosed = true;
+}
+
+void jade::SetMainThreadWakeupFd(int fd) {
+	g_ExtraWakeupFd = fd;
+}
+
 #endif // WIN32
\ No newline at end of file
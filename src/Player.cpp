@@ -1,6 +1,19 @@
 #include <jade/audio/Player.h>
+#include <jade/audio/PcmRingBuffer.h>
+#include <jade/EventSystem.h>
+#include <jade/Trace.h>
+
 #include <miniaudio.h>
 
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
 namespace {
 	void DeviceDataCallback(ma_device* device, void* output, const void*, ma_uint32 frameCount);
 }
@@ -8,46 +21,160 @@ namespace {
 struct jade::Player::Impl {
 public:
 	enum State {
-		DeviceInitializedBit = 0x1,
-		DeviceStartedBit     = 0x2,
-		IsPlayingNowBit      = 0x4
+		DeviceInitializedBit  = 0x1,
+		DeviceStartedBit      = 0x2,
+		IsPlayingNowBit       = 0x4,
+		ContextInitializedBit = 0x8
+	};
+
+	// About a third of a second at 48 kHz, decoded ahead of the device
+	static constexpr size_t s_RingFrames        = 16384;
+	static constexpr size_t s_DecodeChunkFrames = 1024;
+	static constexpr size_t s_NoBoundary        = SIZE_MAX;
+
+	struct QueuedTrack {
+		uint64_t    id      = UINT64_MAX;
+		std::string path;
+		double      seconds = 0.0;
+	};
+
+	// An opened track, its first chunk is decoded up front so switching to it only
+	// copies samples
+	struct Source {
+		QueuedTrack                   track;
+		std::shared_ptr<IAudioStream> stream;
+		std::vector<float>            preroll;
+		size_t                        prerollOffset = 0;
 	};
 
 public:
-	Impl() {
-		this->stream = std::make_shared<AudioStream>();
+	Impl(Device deviceType) {
+		if (deviceType == Device::Null) {
+			ma_backend backends[] = { ma_backend_null };
+			if (ma_context_init(backends, 1, nullptr, &this->context) != MA_SUCCESS) {
+				throw std::runtime_error("Failed to initialize null audio backend");
+			}
+			this->states |= State::ContextInitializedBit;
+		}
+		// Every track is converted to the device's own channel count and sample rate,
+		// so the ring never has to change format between tracks
+		ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
+		deviceConfig.playback.format  = ma_format_f32;
+		deviceConfig.dataCallback	  = DeviceDataCallback;
+		deviceConfig.pUserData        = this;
+
+		ma_context* context = (this->states & State::ContextInitializedBit) ? &this->context : nullptr;
+		if (ma_device_init(context, &deviceConfig, &this->device) == MA_SUCCESS) {
+			this->channelCount = this->device.playback.channels;
+			this->sampleRate   = this->device.sampleRate;
+			this->ring.Reset(s_RingFrames * this->channelCount);
+			this->decodeBuffer.resize(s_DecodeChunkFrames * this->channelCount);
+			this->states |= State::DeviceInitializedBit;
+		}
+		this->decoderThread = std::thread([this]() { DecodeLoop(); });
 	}
 
 public:
-	bool SetTrack(const std::string& path, double duration) {
-		this->stream->Initialize(path, duration);
-
-		if (!(this->states & State::DeviceInitializedBit)) {
-			ma_device_config deviceConfig  = ma_device_config_init(ma_device_type_playback);
-			deviceConfig.playback.format   = ma_format_f32;
-			deviceConfig.playback.channels = this->stream->GetChannelCount();
-			deviceConfig.sampleRate		   = (ma_uint32)this->stream->GetSampleRate();
-			deviceConfig.dataCallback	   = DeviceDataCallback;
-			deviceConfig.pUserData         = this;
-
-			ma_device_init(nullptr, &deviceConfig, &this->device);
-			this->states |= State::DeviceInitializedBit;
+	// Replaces the queue, the track is opened by the decoder thread
+	void Play(QueuedTrack track) {
+		if (this->states & State::IsPlayingNowBit) {
+			Stop();
+		}
+		{
+			std::lock_guard<std::mutex> lock(this->streamMutex);
+			DropBuffered();
+			this->queue.clear();
+			this->queue.push_back(std::move(track));
+			this->next = {};
+			this->hasTrack = true;
+			++this->generation;
+		}
+		RequestDecode();
+		Start();
+	}
+
+	// An idle player starts the track right away
+	void Enqueue(QueuedTrack track) {
+		bool isIdle = false;
+		{
+			std::lock_guard<std::mutex> lock(this->streamMutex);
+			isIdle = !this->hasTrack ||
+				(this->isStreamEnded.load(std::memory_order_relaxed) && this->ring.GetReadable() == 0);
+
+			if (!isIdle) {
+				this->queue.push_back(std::move(track));
+				this->isStreamEnded.store(false, std::memory_order_release);
+			}
+		}
+		if (isIdle) {
+			Play(std::move(track));
+		}
+		else {
+			RequestDecode();
+		}
+	}
+
+	bool Skip() {
+		bool wasPlaying = this->states & State::IsPlayingNowBit;
+		if (wasPlaying) {
+			Stop();
+		}
+		bool hasNext = false;
+		{
+			std::lock_guard<std::mutex> lock(this->streamMutex);
+			bool isPending = this->trackBoundary.load(std::memory_order_relaxed) != s_NoBoundary;
+
+			hasNext = isPending || this->next.stream || !this->queue.empty();
+			if (hasNext) {
+				DropBuffered();
+			}
+		}
+		if (hasNext) {
+			RequestDecode();
+		}
+		if (hasNext || wasPlaying) {
+			Start();
+		}
+		return hasNext;
+	}
+
+	size_t GetQueueSize() {
+		std::lock_guard<std::mutex> lock(this->streamMutex);
+		bool isPending = this->trackBoundary.load(std::memory_order_relaxed) != s_NoBoundary;
+
+		return this->queue.size() + (this->next.stream ? 1 : 0) + (isPending ? 1 : 0);
+	}
+
+	void SetSpeed(double speed) {
+		std::lock_guard<std::mutex> lock(this->streamMutex);
+		this->speed = speed;
+
+		if (this->current.stream) {
+			this->current.stream = jade::SetSpeed(this->current.stream, speed);
+		}
+		if (this->next.stream) {
+			this->next.stream = jade::SetSpeed(this->next.stream, speed);
 		}
-		return true;
 	}
 
 	void Start() {
-		ma_device_start(&this->device);
-		this->states |= State::IsPlayingNowBit;
+		if (this->states & State::DeviceInitializedBit) {
+			ma_device_start(&this->device);
+			this->states |= State::IsPlayingNowBit;
+		}
 	}
 
 	void Stop() {
-		ma_device_stop(&this->device);
+		if (this->states & State::DeviceInitializedBit) {
+			ma_device_stop(&this->device);
+		}
 		this->states &= ~State::IsPlayingNowBit;
 	}
 
 	void SetVolume(float volume) {
-		ma_device_set_master_volume(&this->device, volume);
+		if (this->states & State::DeviceInitializedBit) {
+			ma_device_set_master_volume(&this->device, volume);
+		}
 	}
 
 	void Terminate() {
@@ -57,17 +184,210 @@ public:
 			}
 			ma_device_uninit(&this->device);
 		}
+		if (this->decoderThread.joinable()) {
+			this->isDecoderStopping.store(true, std::memory_order_release);
+			RequestDecode();
+			this->decoderThread.join();
+		}
+		if (this->states & State::ContextInitializedBit) {
+			ma_context_uninit(&this->context);
+		}
 		this->states = 0;
 	}
 
+	// Lock-free, called by the audio callback whenever the ring runs low
+	void RequestDecode() noexcept {
+		this->decodeRequests.fetch_add(1, std::memory_order_release);
+		this->decodeRequests.notify_one();
+	}
+
+	void DecodeLoop() {
+		JADE_TRACE_THREAD("Decoder");
+
+		while (!this->isDecoderStopping.load(std::memory_order_acquire)) {
+			uint32_t seenRequests = this->decodeRequests.load(std::memory_order_acquire);
+			ReportPlayback();
+			Decode();
+			this->decodeRequests.wait(seenRequests, std::memory_order_acquire);
+		}
+	}
+
+	// The callback only counts track starts and finishes, emitting may lock, allocate
+	// and wake the main thread. A start is reported before Decode() can set the next
+	// boundary, so the published track id is still the one that started.
+	void ReportPlayback() {
+		uint32_t starts = this->startedCount.load(std::memory_order_acquire);
+		if (starts != this->reportedStarts) {
+			this->reportedStarts = starts;
+			EventEmitter<OnTrackStarted>().Emit(OnTrackStarted{
+				.trackID = this->startedTrackID.load(std::memory_order_relaxed)
+			});
+		}
+		uint32_t finishes = this->finishedCount.load(std::memory_order_acquire);
+		if (finishes != this->reportedFinishes) {
+			this->reportedFinishes = finishes;
+			EventEmitter<OnPlaybackFinished>().Emit();
+		}
+	}
+
+	// Tops the ring up. A track that ends mid-chunk is followed by the first frame of
+	// the next one, and once the ring is full the next queued track is opened.
+	void Decode() {
+		JADE_TRACE_SCOPE("Player::Decode");
+		if (this->channelCount == 0) {
+			return;
+		}
+		std::unique_lock<std::mutex> lock(this->streamMutex);
+
+		while (!this->isDecoderStopping.load(std::memory_order_acquire)) {
+			if (!this->current.stream) {
+				if (this->next.stream) {
+					// The callback reports one track start at a time
+					if (this->trackBoundary.load(std::memory_order_acquire) != s_NoBoundary) {
+						return;
+					}
+					this->current = std::move(this->next);
+					this->next = {};
+					this->pendingTrack = this->current.track;
+
+					this->boundaryTrackID.store(this->current.track.id, std::memory_order_relaxed);
+					this->trackBoundary.store(this->ring.GetWritePosition(), std::memory_order_release);
+				}
+				else if (!this->queue.empty()) {
+					OpenNext(lock);
+				}
+				else {
+					this->isStreamEnded.store(true, std::memory_order_release);
+					return;
+				}
+				continue;
+			}
+			if (this->ring.GetWritable() >= this->decodeBuffer.size()) {
+				size_t frames = Read(this->current, this->decodeBuffer);
+				this->ring.Write(this->decodeBuffer.data(), frames * this->channelCount);
+
+				if (frames < s_DecodeChunkFrames) {
+					this->current = {};
+				}
+				continue;
+			}
+			if (!this->next.stream && !this->queue.empty()) {
+				OpenNext(lock);
+				continue;
+			}
+			return;
+		}
+	}
+
+	// The file is opened without holding the lock so Play() never waits for it. A
+	// queue replaced in the meantime discards the result, an unreadable file is skipped.
+	void OpenNext(std::unique_lock<std::mutex>& lock) {
+		JADE_TRACE_SCOPE("Player::OpenNext");
+
+		QueuedTrack track   = this->queue.front();
+		uint64_t generation = this->generation;
+		double speed        = this->speed;
+
+		lock.unlock();
+		Source source = Open(std::move(track), speed);
+		lock.lock();
+
+		if (generation != this->generation) {
+			return;
+		}
+		this->queue.pop_front();
+		if (source.stream && speed != this->speed) {
+			source.stream = jade::SetSpeed(source.stream, this->speed);
+		}
+		this->next = std::move(source);
+	}
+
+	Source Open(QueuedTrack track, double speed) const {
+		Source source;
+		std::shared_ptr<IAudioStream> stream = std::make_shared<AudioStream>(this->channelCount, this->sampleRate);
+		if (!stream->Initialize(track.path, track.seconds)) {
+			return source;
+		}
+		if (speed != 1.0) {
+			stream = jade::SetSpeed(stream, speed);
+		}
+		source.preroll.resize(s_DecodeChunkFrames * this->channelCount);
+		source.preroll.resize(stream->Read(source.preroll) * this->channelCount);
+
+		source.track  = std::move(track);
+		source.stream = std::move(stream);
+		return source;
+	}
+
+	size_t Read(Source& source, std::span<float> out) {
+		size_t copied = std::min(out.size(), source.preroll.size() - source.prerollOffset);
+		std::copy_n(source.preroll.data() + source.prerollOffset, copied, out.data());
+		source.prerollOffset += copied;
+
+		size_t frames = copied / this->channelCount;
+		if (copied < out.size()) {
+			frames += source.stream->Read(out.subspan(copied));
+		}
+		return frames;
+	}
+
+	// The device must be stopped. Tracks already decoded into the ring but not heard
+	// yet go back to the front of the queue.
+	void DropBuffered() {
+		if (this->trackBoundary.load(std::memory_order_relaxed) != s_NoBoundary) {
+			if (this->next.stream) {
+				this->queue.push_front(std::move(this->next.track));
+				this->next = {};
+			}
+			this->queue.push_front(std::move(this->pendingTrack));
+			++this->generation;
+		}
+		this->current = {};
+		this->ring.Clear();
+		this->trackBoundary.store(s_NoBoundary, std::memory_order_relaxed);
+		this->isStreamEnded.store(false, std::memory_order_relaxed);
+		this->finishNotified.store(false, std::memory_order_relaxed);
+	}
+
 public:
-	uint64_t					  states = 0;
-	std::shared_ptr<IAudioStream> stream = {};
-	ma_device					  device = {};
+	uint64_t   states       = 0;
+	ma_device  device       = {};
+	ma_context context      = {};
+	uint32_t   channelCount = 0;
+	uint32_t   sampleRate   = 0;
+
+	// Only the decoder thread reads the streams, the callback only reads the ring
+	PcmRingBuffer           ring;
+	std::mutex              streamMutex;
+	std::deque<QueuedTrack> queue;
+	Source                  current;
+	Source                  next;
+	uint64_t                generation = 0; // bumped whenever the queue front is replaced
+	double                  speed      = 1.0;
+	bool                    hasTrack   = false;
+	std::vector<float>      decodeBuffer;
+
+	std::thread           decoderThread;
+	std::atomic<uint32_t> decodeRequests{ 0 };
+	std::atomic<bool>     isDecoderStopping{ false };
+	std::atomic<bool>     isStreamEnded{ false };
+	std::atomic<bool>     finishNotified{ false };
+
+	// Published by the callback, reported by the decoder thread
+	std::atomic<uint64_t> startedTrackID{ UINT64_MAX };
+	std::atomic<uint32_t> startedCount{ 0 };
+	std::atomic<uint32_t> finishedCount{ 0 };
+	uint32_t              reportedStarts   = 0;
+	uint32_t              reportedFinishes = 0;
+
+	// Ring position of the first sample of 'pendingTrack' until the callback played it
+	QueuedTrack           pendingTrack;
+	std::atomic<size_t>   trackBoundary{ s_NoBoundary };
+	std::atomic<uint64_t> boundaryTrackID{ UINT64_MAX };
 };
 
-jade::Player::Player() {
-	m_impl = std::make_unique<Impl>();
+jade::Player::Player(Device device) {
+	m_impl = std::make_unique<Impl>(device);
 }
 
 jade::Player::~Player() {
@@ -82,8 +402,19 @@ bool jade::Player::IsPlaying() const {
 }
 
 void jade::Player::Play(const MusicLibrary::TrackElement& track) {
-	m_impl->SetTrack(track.audioPath.string(), track.seconds);
-	m_impl->Start();
+	m_impl->Play(Impl::QueuedTrack{ .id = track.id, .path = track.audioPath.string(), .seconds = track.seconds });
+}
+
+void jade::Player::Enqueue(const MusicLibrary::TrackElement& track) {
+	m_impl->Enqueue(Impl::QueuedTrack{ .id = track.id, .path = track.audioPath.string(), .seconds = track.seconds });
+}
+
+bool jade::Player::Skip() {
+	return m_impl->Skip();
+}
+
+size_t jade::Player::GetQueueSize() const {
+	return m_impl->GetQueueSize();
 }
 
 void jade::Player::Resume() {
@@ -103,22 +434,50 @@ void jade::Player::SetVolume(float volume) {
 }
 
 void jade::Player::SetSpeed(double speed) {
-	m_impl->stream = jade::SetSpeed(m_impl->stream, speed);
+	m_impl->SetSpeed(speed);
 }
 
 namespace {
+	// Realtime thread: copies out of the ring and never allocates, locks, touches files
+	// or emits events. The decoder thread it wakes reports starts and finishes.
 	void DeviceDataCallback(ma_device* device, void* output, const void*, ma_uint32 frameCount) {
-		jade::Player::Impl* player = (jade::Player::Impl*)device->pUserData;
-		std::vector<float> frame = player->stream->Read(frameCount);
+		JADE_TRACE_THREAD("Audio");
+		JADE_TRACE_SCOPE("Player::DeviceDataCallback");
 
+		jade::Player::Impl* player = (jade::Player::Impl*)device->pUserData;
 		float* out = (float*)output;
 
-		size_t sampleCount = frame.size();
-		for (size_t i = 0; i < sampleCount; ++i) {
-			out[i] = frame[i];
+		size_t sampleCount = (size_t)frameCount * device->playback.channels;
+		size_t position    = player->ring.GetReadPosition();
+		size_t readCount   = player->ring.Read(out, sampleCount);
+
+		// The first sample of the next track was part of this read
+		size_t boundary = player->trackBoundary.load(std::memory_order_acquire);
+		if (boundary != jade::Player::Impl::s_NoBoundary && position + readCount > boundary) {
+			uint64_t trackID = player->boundaryTrackID.load(std::memory_order_relaxed);
+			player->trackBoundary.store(jade::Player::Impl::s_NoBoundary, std::memory_order_release);
+			player->finishNotified.store(false, std::memory_order_relaxed);
+
+			player->startedTrackID.store(trackID, std::memory_order_relaxed);
+			player->startedCount.fetch_add(1, std::memory_order_release);
+			player->RequestDecode();
+		}
+
+		if (readCount < sampleCount) {
+			std::memset(out + readCount, 0, (sampleCount - readCount) * sizeof(float));
+
+			// Running dry is the end of the queue once the decoder has nothing left,
+			// otherwise an underrun that is padded with silence
+			if (player->isStreamEnded.load(std::memory_order_acquire) && player->ring.GetReadable() == 0 &&
+				!player->finishNotified.exchange(true, std::memory_order_relaxed)) {
+				player->finishedCount.fetch_add(1, std::memory_order_release);
+				player->RequestDecode();
+			}
 		}
-		for (size_t i = sampleCount; i < (size_t)frameCount * player->device.playback.channels; ++i) {
-			out[i] = 0;
+		// Nothing is left to decode once the stream ended, Enqueue() wakes the decoder
+		bool isStreamEnded = player->isStreamEnded.load(std::memory_order_acquire);
+		if (!isStreamEnded && player->ring.GetReadable() <= player->ring.GetCapacity() / 2) {
+			player->RequestDecode();
 		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include <jade/Profiler.h>
+#include <jade/EventSystem.h>
+
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+namespace {
+	constexpr const char* g_StageNames[jade::Profiler::s_StageCount] = {
+		"frame", "render", "input", "backend", "timers", "dispatch", "wait"
+	};
+
+	jade::Profiler g_Profiler;
+}
+
+jade::Profiler::Profiler() : m_histograms(s_SlotCount) {}
+
+jade::Profiler& jade::Profiler::Get() noexcept { return g_Profiler; }
+const jade::Profiler& jade::Profiler::GetConst() noexcept { return g_Profiler; }
+
+void jade::Profiler::Record(size_t slot, uint64_t nanoseconds) noexcept {
+	_Histogram& histogram = m_histograms[slot];
+	histogram.samples[histogram.head] = nanoseconds;
+	histogram.head = (histogram.head + 1) % s_SampleCount;
+	++histogram.total;
+}
+
+jade::Profiler::Summary jade::Profiler::Summarize(size_t slot) const {
+	const _Histogram& histogram = m_histograms[slot];
+	size_t count = (size_t)std::min<uint64_t>(histogram.total, s_SampleCount);
+
+	Summary summary;
+	summary.samples = count;
+	summary.total   = histogram.total;
+	if (count == 0) {
+		return summary;
+	}
+	std::array<uint64_t, s_SampleCount> sorted;
+	std::copy_n(histogram.samples.begin(), count, sorted.begin());
+
+	auto percentile = [&](size_t rank) {
+		std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + count);
+		return (double)sorted[rank] * 1e-3;
+	};
+	summary.max = percentile(count - 1);
+	summary.p99 = percentile((count - 1) * 99 / 100);
+	summary.p50 = percentile((count - 1) / 2);
+	return summary;
+}
+
+std::string jade::Profiler::Report() const {
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(1);
+
+	auto writeRow = [&](std::string_view name, size_t slot) {
+		Summary summary = Summarize(slot);
+		if (summary.samples == 0) {
+			return;
+		}
+		out << "\t" << std::left << std::setw(24) << name << std::right
+			<< " p50 " << std::setw(9) << summary.p50 << " us"
+			<< "  p99 " << std::setw(9) << summary.p99 << " us"
+			<< "  max " << std::setw(9) << summary.max << " us"
+			<< "  (" << summary.total << ")\n";
+	};
+
+	out << "Stages (last " << s_SampleCount << " samples):\n";
+	for (size_t i = 0; i < s_StageCount; ++i) {
+		writeRow(g_StageNames[i], StageSlot((ProfileStage)i));
+	}
+	out << "Events (per dispatched run):\n";
+	for (size_t i = 0; i < EventSystem::s_EventCount; ++i) {
+		writeRow(EventSystem::s_EventNames[i], EventSlot(i));
+	}
+	return out.str();
+}
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include <jade/RadixTree.h>
+
+#include <algorithm>
+
+jade::RadixTree::RadixTree() {
+	m_nodes.emplace_back();
+}
+
+void jade::RadixTree::Insert(std::string_view key, uint64_t value) {
+	// Counts only cover distinct keys, a repeated key keeps its first value
+	uint32_t existing = _FindNode(key);
+	if (existing != s_None && m_nodes[existing].isTerminal) {
+		return;
+	}
+	uint32_t node = 0;
+	size_t position = 0;
+
+	while (true) {
+		++m_nodes[node].count;
+
+		if (position == key.size()) {
+			m_nodes[node].isTerminal = true;
+			m_nodes[node].value      = value;
+			return;
+		}
+		uint32_t previous = s_None;
+		uint32_t child = _FindChild(node, key[position], &previous);
+
+		if (child == s_None) {
+			_Node leaf = {
+				.offset     = (uint32_t)m_chars.size(),
+				.length     = (uint32_t)(key.size() - position),
+				.count      = 1,
+				.isTerminal = true,
+				.value      = value
+			};
+			m_chars.append(key.substr(position));
+
+			// Siblings stay sorted by their first character
+			uint32_t next = previous == s_None ? m_nodes[node].firstChild : m_nodes[previous].nextSibling;
+			leaf.nextSibling = next;
+			m_nodes.push_back(leaf);
+
+			uint32_t leafIndex = (uint32_t)m_nodes.size() - 1;
+			if (previous == s_None) m_nodes[node].firstChild = leafIndex;
+			else m_nodes[previous].nextSibling = leafIndex;
+			return;
+		}
+		std::string_view label = _Label(m_nodes[child]);
+		std::string_view rest  = key.substr(position);
+		size_t common = std::mismatch(label.begin(), label.end(), rest.begin(), rest.end()).first - label.begin();
+
+		if (common < label.size()) {
+			// Split the edge, the upper part takes the child's place among its siblings
+			_Node upper = {
+				.offset      = m_nodes[child].offset,
+				.length      = (uint32_t)common,
+				.firstChild  = child,
+				.nextSibling = m_nodes[child].nextSibling,
+				.count       = m_nodes[child].count
+			};
+			m_nodes.push_back(upper);
+			uint32_t upperIndex = (uint32_t)m_nodes.size() - 1;
+
+			_Node& lower = m_nodes[child];
+			lower.offset     += (uint32_t)common;
+			lower.length     -= (uint32_t)common;
+			lower.nextSibling = s_None;
+
+			if (previous == s_None) m_nodes[node].firstChild = upperIndex;
+			else m_nodes[previous].nextSibling = upperIndex;
+			child = upperIndex;
+		}
+		node = child;
+		position += common;
+	}
+}
+
+void jade::RadixTree::Clear() {
+	m_nodes.clear();
+	m_chars.clear();
+	m_nodes.emplace_back();
+}
+
+uint64_t jade::RadixTree::Find(std::string_view key) const noexcept {
+	uint32_t node = _FindNode(key);
+	return node != s_None && m_nodes[node].isTerminal ? m_nodes[node].value : s_NoValue;
+}
+
+jade::RadixTree::Completion jade::RadixTree::Complete(std::string_view prefix, size_t maxCandidates) const {
+	Completion completion;
+	uint32_t node = 0;
+	size_t position = 0;
+
+	completion.completed.assign(prefix);
+
+	while (position < prefix.size()) {
+		node = _FindChild(node, prefix[position]);
+		if (node == s_None) {
+			return completion;
+		}
+		std::string_view label = _Label(m_nodes[node]);
+		std::string_view rest  = prefix.substr(position);
+		size_t length = std::min(label.size(), rest.size());
+
+		if (label.substr(0, length) != rest.substr(0, length)) {
+			return completion;
+		}
+		if (length < label.size()) {
+			completion.completed.append(label.substr(length));
+		}
+		position += length;
+	}
+	// Follow the edges every match shares
+	while (!m_nodes[node].isTerminal && m_nodes[node].firstChild != s_None &&
+		m_nodes[m_nodes[node].firstChild].nextSibling == s_None) {
+		node = m_nodes[node].firstChild;
+		completion.completed.append(_Label(m_nodes[node]));
+	}
+	completion.matchCount = m_nodes[node].count;
+
+	std::string key = completion.completed;
+	_Collect(node, key, maxCandidates, completion.candidates);
+	return completion;
+}
+
+uint32_t jade::RadixTree::_FindNode(std::string_view key) const noexcept {
+	uint32_t node = 0;
+	size_t position = 0;
+
+	while (position < key.size()) {
+		node = _FindChild(node, key[position]);
+		if (node == s_None) {
+			return s_None;
+		}
+		std::string_view label = _Label(m_nodes[node]);
+		if (key.substr(position, label.size()) != label) {
+			return s_None;
+		}
+		position += label.size();
+	}
+	return node;
+}
+
+uint32_t jade::RadixTree::_FindChild(uint32_t node, char c, uint32_t* previous) const noexcept {
+	uint32_t before = s_None;
+	for (uint32_t child = m_nodes[node].firstChild; child != s_None; child = m_nodes[child].nextSibling) {
+		unsigned char first = (unsigned char)m_chars[m_nodes[child].offset];
+		if (first == (unsigned char)c) {
+			if (previous) *previous = before;
+			return child;
+		}
+		if (first > (unsigned char)c) {
+			break;
+		}
+		before = child;
+	}
+	if (previous) *previous = before;
+	return s_None;
+}
+
+void jade::RadixTree::_Collect(uint32_t node, std::string& key, size_t maxCandidates, std::vector<Candidate>& candidates) const {
+	if (candidates.size() >= maxCandidates) {
+		return;
+	}
+	if (m_nodes[node].isTerminal) {
+		candidates.push_back(Candidate{ .key = key, .value = m_nodes[node].value });
+	}
+	for (uint32_t child = m_nodes[node].firstChild; child != s_None && candidates.size() < maxCandidates;
+		child = m_nodes[child].nextSibling) {
+		size_t size = key.size();
+		key.append(_Label(m_nodes[child]));
+		_Collect(child, key, maxCandidates, candidates);
+		key.resize(size);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include <jade/TaskGraph.h>
+#include <jade/EventSystem.h>
+#include <jade/AsyncTask.h>
+#include <jade/Trace.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+void jade::TaskGraph::Context::SetProgress(float progress) noexcept {
+	m_graph._SetNodeProgress(m_node, std::clamp(progress, 0.0f, 1.0f));
+	m_graph._UpdateTaskProgress();
+}
+
+jade::TaskGraph::NodeID jade::TaskGraph::Context::AddChild(
+std::string name, std::function<void(Context&)> function,
+std::initializer_list<NodeID> dependencies, float weight, TaskPriority priority) {
+	return m_graph._AddNode(&m_node, std::move(name), std::move(function), dependencies, weight, priority);
+}
+
+jade::TaskGraph::TaskGraph(TaskType type, const std::shared_ptr<FutureTask>& task, CancellationToken token) :
+m_type(type), m_task(task), m_token(std::move(token)) {}
+
+std::shared_ptr<jade::TaskGraph> jade::TaskGraph::Create(TaskType type, const std::shared_ptr<FutureTask>& task) {
+	CancellationToken token = task ? task->GetCancellationToken().CreateChild() : CancellationToken();
+	return std::shared_ptr<TaskGraph>(new TaskGraph(type, task, std::move(token)));
+}
+
+jade::TaskGraph::NodeID jade::TaskGraph::AddNode(
+std::string name, Function function,
+std::initializer_list<NodeID> dependencies, float weight, TaskPriority priority) {
+	return _AddNode(nullptr, std::move(name), std::move(function), dependencies, weight, priority);
+}
+
+jade::TaskGraph::NodeID jade::TaskGraph::AddMainThreadNode(
+std::string name, Function function, std::initializer_list<NodeID> dependencies, float weight) {
+	return _AddNode(nullptr, std::move(name), std::move(function), dependencies, weight, TaskPriority::Normal, true);
+}
+
+std::future<void> jade::TaskGraph::Launch() {
+	std::future<void> future = m_completion.get_future();
+	std::vector<_Node*> roots;
+	{
+		std::lock_guard<std::mutex> lock(m_nodesMutex);
+		if (m_launched) {
+			throw std::runtime_error("Task graph has already been launched");
+		}
+		m_launched = true;
+
+		for (std::unique_ptr<_Node>& node : m_nodes) {
+			if (node->remainingDependencies.load(std::memory_order_relaxed) == 0) {
+				roots.push_back(node.get());
+			}
+		}
+	}
+	if (roots.empty()) {
+		_Complete();
+		return future;
+	}
+	for (_Node* root : roots) {
+		_Schedule(*root);
+	}
+	return future;
+}
+
+float jade::TaskGraph::GetProgress() const noexcept {
+	float total = m_totalWeight.load(std::memory_order_relaxed);
+	if (total <= 0.0f) {
+		return 0.0f;
+	}
+	return std::clamp(m_doneWeight.load(std::memory_order_relaxed) / total, 0.0f, 1.0f);
+}
+
+jade::TaskGraph::NodeID jade::TaskGraph::_AddNode(_Node* parent, std::string&& name, Function&& function,
+std::initializer_list<NodeID> dependencies, float weight, TaskPriority priority, bool isMainThread) {
+	std::unique_ptr<_Node> node = std::make_unique<_Node>();
+	node->name         = std::move(name);
+	node->function     = std::move(function);
+	node->weight       = weight;
+	node->priority     = priority;
+	node->parent       = parent;
+	node->isMainThread = isMainThread;
+
+	_Node* added = node.get();
+	NodeID id;
+	bool ready;
+	{
+		std::lock_guard<std::mutex> lock(m_nodesMutex);
+		uint32_t remaining = 0;
+		for (NodeID dependency : dependencies) {
+			if (dependency >= m_nodes.size()) {
+				throw std::invalid_argument("Task graph dependency refers to an unknown node");
+			}
+			_Node& dependencyNode = *m_nodes[dependency];
+			if (!dependencyNode.completed) {
+				dependencyNode.successors.push_back(added);
+				++remaining;
+			}
+		}
+		added->remainingDependencies.store(remaining, std::memory_order_relaxed);
+		if (parent != nullptr) {
+			parent->pendingWork.fetch_add(1, std::memory_order_relaxed);
+		}
+		m_pendingNodes.fetch_add(1, std::memory_order_relaxed);
+		m_totalWeight.fetch_add(weight, std::memory_order_relaxed);
+
+		id = (NodeID)m_nodes.size();
+		m_nodes.emplace_back(std::move(node));
+		ready = m_launched && remaining == 0;
+	}
+	if (ready) {
+		_Schedule(*added);
+	}
+	return id;
+}
+
+void jade::TaskGraph::_Schedule(_Node& node) {
+	if (node.isMainThread) {
+		[](std::shared_ptr<TaskGraph> graph, _Node& node) -> _jade::DetachedTask {
+			co_await ResumeOnMainThread();
+			graph->_Run(node);
+		}(shared_from_this(), node);
+		return;
+	}
+	ThreadPool::Get().Post([graph = shared_from_this(), &node]() {
+		graph->_Run(node);
+	}, node.priority);
+}
+
+void jade::TaskGraph::_SetNodeProgress(_Node& node, float progress) noexcept {
+	float previous = node.progress.exchange(progress, std::memory_order_relaxed);
+	m_doneWeight.fetch_add(node.weight * (progress - previous), std::memory_order_relaxed);
+}
+
+void jade::TaskGraph::_Run(_Node& node) {
+	if (!m_token.IsCancelled()) {
+		JADE_TRACE_SCOPE("TaskGraph node");
+		try {
+			Context context(*this, node);
+			node.function(context);
+		}
+		catch (const std::exception& error) {
+			_Fail(node.name + ": " + error.what());
+		}
+		catch (...) {
+			_Fail(node.name + ": unknown error");
+		}
+	}
+	node.function = nullptr;
+	_FinishWork(node);
+}
+
+void jade::TaskGraph::_Fail(const std::string& error) {
+	{
+		std::lock_guard<std::mutex> lock(m_errorMutex);
+		if (!m_failed) {
+			m_failed = true;
+			m_error  = error;
+		}
+	}
+	m_token.Cancel();
+}
+
+void jade::TaskGraph::_FinishWork(_Node& node) {
+	if (node.pendingWork.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+		return;
+	}
+	_SetNodeProgress(node, 1.0f);
+
+	std::vector<_Node*> ready;
+	{
+		std::lock_guard<std::mutex> lock(m_nodesMutex);
+		node.completed = true;
+		for (_Node* successor : node.successors) {
+			if (successor->remainingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				ready.push_back(successor);
+			}
+		}
+	}
+	for (_Node* successor : ready) {
+		_Schedule(*successor);
+	}
+	_UpdateTaskProgress();
+
+	if (node.parent != nullptr) {
+		_FinishWork(*node.parent);
+	}
+	if (m_pendingNodes.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		_Complete();
+	}
+}
+
+void jade::TaskGraph::_Complete() {
+	OnTaskEnded::Status status = OnTaskEnded::Status::Success;
+	std::string error;
+	{
+		std::lock_guard<std::mutex> lock(m_errorMutex);
+		if (m_failed) {
+			status = OnTaskEnded::Status::Failed;
+			error  = m_error;
+		}
+		else if (m_token.IsCancelled()) {
+			status = OnTaskEnded::Status::Cancelled;
+		}
+	}
+	m_completion.set_value();
+
+	EventEmitter<OnAsyncTaskEnded>().Emit(OnAsyncTaskEnded{
+		.status   = status,
+		.whatTask = m_type,
+		.category = TaskCategory::Async,
+		.task     = m_task,
+		.errorMsg = std::move(error)
+	});
+}
+
+void jade::TaskGraph::_UpdateTaskProgress() const {
+	if (m_task) {
+		m_task->SetProgress(GetProgress());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include <jade/TaskRegistry.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+jade::TaskRegistry::TaskRegistry() {
+	m_limits.fill(1);
+}
+
+void jade::TaskRegistry::SetConcurrencyLimit(TaskType type, size_t limit) {
+	if (limit == 0) {
+		throw std::invalid_argument("Task concurrency limit must be positive");
+	}
+	m_limits[(size_t)type] = limit;
+	_LaunchQueued(type);
+}
+
+jade::TaskRegistry::TaskID jade::TaskRegistry::Submit(TaskType type, std::string description, Launcher launcher) {
+	_ReleaseRetired();
+
+	TaskID id = m_nextID++;
+	_Entry& entry = m_entries[id];
+	entry.type        = type;
+	entry.description = std::move(description);
+	entry.launcher    = std::move(launcher);
+
+	if (m_runningCounts[(size_t)type] < m_limits[(size_t)type]) {
+		_Launch(id, entry);
+	}
+	else {
+		m_queues[(size_t)type].push_back(id);
+	}
+	return id;
+}
+
+jade::TaskRegistry::CancelResult jade::TaskRegistry::Cancel(TaskID id) {
+	auto it = m_entries.find(id);
+	if (it == m_entries.end()) {
+		return CancelResult::NotFound;
+	}
+	_Entry& entry = it->second;
+	switch (entry.state) {
+		case TaskState::Queued: {
+			std::deque<TaskID>& queue = m_queues[(size_t)entry.type];
+			queue.erase(std::find(queue.begin(), queue.end(), id));
+			m_entries.erase(it);
+			return CancelResult::Dropped;
+		}
+		case TaskState::Running:
+			if (!IsCancellable(entry.type)) {
+				return CancelResult::NotCancellable;
+			}
+			entry.task->Cancel();
+			entry.state = TaskState::Cancelling;
+			return CancelResult::Cancelling;
+
+		case TaskState::Cancelling:
+			return CancelResult::Cancelling;
+	}
+	return CancelResult::NotFound;
+}
+
+void jade::TaskRegistry::CancelAll() {
+	for (std::deque<TaskID>& queue : m_queues) {
+		for (TaskID id : queue) {
+			m_entries.erase(id);
+		}
+		queue.clear();
+	}
+	for (auto& [id, entry] : m_entries) {
+		if (entry.state == TaskState::Running && IsCancellable(entry.type)) {
+			entry.task->Cancel();
+			entry.state = TaskState::Cancelling;
+		}
+	}
+}
+
+jade::TaskRegistry::TaskID jade::TaskRegistry::OnTaskEnded(OnAsyncTaskEnded& endedTask) {
+	if (!endedTask.task) {
+		return s_InvalidID;
+	}
+	auto it = std::find_if(m_entries.begin(), m_entries.end(), [&](const auto& pair) {
+		return pair.second.task == endedTask.task;
+	});
+	if (it == m_entries.end()) {
+		return s_InvalidID;
+	}
+	TaskID id = it->first;
+	TaskType type = it->second.type;
+
+	// The job emits before it returns, so its future may not be ready yet
+	m_retired.emplace_back(std::move(it->second.task));
+	m_entries.erase(it);
+	endedTask.task.reset();
+	--m_runningCounts[(size_t)type];
+
+	_LaunchQueued(type);
+	_ReleaseRetired();
+	return id;
+}
+
+jade::TaskRegistry::TaskState jade::TaskRegistry::GetState(TaskID id) const {
+	auto it = m_entries.find(id);
+	if (it == m_entries.end()) {
+		throw std::out_of_range("Unknown task handle");
+	}
+	return it->second.state;
+}
+
+std::vector<jade::TaskRegistry::TaskInfo> jade::TaskRegistry::GetTasks() const {
+	std::vector<TaskInfo> tasks;
+	tasks.reserve(m_entries.size());
+
+	for (const auto& [id, entry] : m_entries) {
+		tasks.push_back(TaskInfo{
+			.id          = id,
+			.type        = entry.type,
+			.state       = entry.state,
+			.progress    = entry.task ? entry.task->GetProgress() : 0.0f,
+			.description = entry.description
+		});
+	}
+	return tasks;
+}
+
+void jade::TaskRegistry::_Launch(TaskID id, _Entry& entry) {
+	entry.task  = std::make_shared<FutureTask>();
+	entry.state = TaskState::Running;
+	++m_runningCounts[(size_t)entry.type];
+
+	Launcher launcher = std::move(entry.launcher);
+	try {
+		entry.task->SetTask(launcher(entry.task));
+	}
+	catch (...) {
+		--m_runningCounts[(size_t)entry.type];
+		m_entries.erase(id);
+		throw;
+	}
+}
+
+void jade::TaskRegistry::_LaunchQueued(TaskType type) {
+	std::deque<TaskID>& queue = m_queues[(size_t)type];
+	while (!queue.empty() && m_runningCounts[(size_t)type] < m_limits[(size_t)type]) {
+		TaskID id = queue.front();
+		queue.pop_front();
+		_Launch(id, m_entries.at(id));
+	}
+}
+
+void jade::TaskRegistry::_ReleaseRetired() {
+	std::erase_if(m_retired, [](const std::shared_ptr<FutureTask>& task) {
+		return task.use_count() == 1 && task->IsReady();
+	});
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include <jade/TimerWheel.h>
+
+#include <bit>
+#include <algorithm>
+
+jade::TimerHandle jade::TimerWheel::Schedule(uint64_t delayTicks, uint64_t intervalTicks, Callback&& callback) {
+	uint32_t index = _Allocate();
+	_Timer& timer = m_timers[index];
+
+	timer.deadline = std::max(m_nowTick + delayTicks, m_currentTick + 1);
+	timer.interval = intervalTicks;
+	timer.state    = _State::Scheduled;
+	timer.callback = std::move(callback);
+
+	_Link(index);
+	m_nextEventTick = std::min(m_nextEventTick, _SlotEventTick(timer.level, timer.slot));
+
+	return TimerHandle{ .index = index, .generation = timer.generation };
+}
+
+bool jade::TimerWheel::Cancel(TimerHandle handle) {
+	if (handle.index >= m_timers.size()) {
+		return false;
+	}
+	_Timer& timer = m_timers[handle.index];
+	if (timer.generation != handle.generation) {
+		return false;
+	}
+	switch (timer.state) {
+		case _State::Scheduled:
+			_Unlink(handle.index);
+			_Release(handle.index);
+			return true;
+
+		case _State::Firing:
+			timer.state = _State::CancelledWhileFiring;
+			return true;
+
+		// Already cancelled from its own callback
+		case _State::CancelledWhileFiring:
+			return false;
+
+		// Releasing a timer bumps its generation, so no handle can match a free one
+		case _State::Free:
+			return false;
+	}
+	return false;
+}
+
+void jade::TimerWheel::Advance(uint64_t nowTick) {
+	m_nowTick = std::max(m_nowTick, nowTick);
+
+	while (m_nextEventTick <= m_nowTick) {
+		m_currentTick = m_nextEventTick;
+		_ProcessTick(m_currentTick);
+		m_nextEventTick = _ComputeNextEventTick();
+	}
+}
+
+uint32_t jade::TimerWheel::_Allocate() {
+	++m_timerCount;
+	if (!m_freeTimers.empty()) {
+		uint32_t index = m_freeTimers.back();
+		m_freeTimers.pop_back();
+		return index;
+	}
+	m_timers.emplace_back();
+	return (uint32_t)(m_timers.size() - 1);
+}
+
+void jade::TimerWheel::_Release(uint32_t index) {
+	_Timer& timer = m_timers[index];
+	timer.callback = {};
+	timer.state = _State::Free;
+	++timer.generation;
+
+	m_freeTimers.push_back(index);
+	--m_timerCount;
+}
+
+void jade::TimerWheel::_Link(uint32_t index) {
+	_Timer& timer = m_timers[index];
+
+	uint64_t placement = std::max(timer.deadline, m_currentTick);
+	uint64_t delta = placement - m_currentTick;
+	uint32_t level = 0;
+
+	while (level + 1 < s_LevelCount && delta >= (1ull << (s_SlotBits * (level + 1)))) {
+		++level;
+	}
+	if (delta >= (1ull << (s_SlotBits * s_LevelCount))) {
+		placement = m_currentTick + (1ull << (s_SlotBits * s_LevelCount)) - 1;
+	}
+	uint32_t slot = (uint32_t)((placement >> (s_SlotBits * level)) & (s_SlotCount - 1));
+
+	timer.level = (uint8_t)level;
+	timer.slot  = (uint8_t)slot;
+	timer.prev  = UINT32_MAX;
+	timer.next  = m_slots[level][slot];
+
+	if (timer.next != UINT32_MAX) {
+		m_timers[timer.next].prev = index;
+	}
+	m_slots[level][slot] = index;
+	m_occupied[level] |= 1ull << slot;
+}
+
+void jade::TimerWheel::_Unlink(uint32_t index) {
+	_Timer& timer = m_timers[index];
+
+	if (timer.prev != UINT32_MAX) {
+		m_timers[timer.prev].next = timer.next;
+	}
+	else {
+		m_slots[timer.level][timer.slot] = timer.next;
+	}
+	if (timer.next != UINT32_MAX) {
+		m_timers[timer.next].prev = timer.prev;
+	}
+	if (m_slots[timer.level][timer.slot] == UINT32_MAX) {
+		m_occupied[timer.level] &= ~(1ull << timer.slot);
+	}
+	timer.prev = timer.next = UINT32_MAX;
+}
+
+void jade::TimerWheel::_ProcessTick(uint64_t tick) {
+	for (uint32_t level = s_LevelCount - 1; level > 0; --level) {
+		if ((tick & ((1ull << (s_SlotBits * level)) - 1)) != 0) {
+			continue;
+		}
+		uint32_t slot = (uint32_t)((tick >> (s_SlotBits * level)) & (s_SlotCount - 1));
+		while (m_slots[level][slot] != UINT32_MAX) {
+			uint32_t index = m_slots[level][slot];
+			_Unlink(index);
+			_Link(index);
+		}
+	}
+	uint32_t slot = (uint32_t)(tick & (s_SlotCount - 1));
+	while (m_slots[0][slot] != UINT32_MAX) {
+		uint32_t index = m_slots[0][slot];
+		_Unlink(index);
+
+		if (m_timers[index].deadline > tick) {
+			_Link(index);
+			continue;
+		}
+		_Fire(index);
+	}
+}
+
+void jade::TimerWheel::_Fire(uint32_t index) {
+	if (m_timers[index].interval == 0) {
+		Callback callback = std::move(m_timers[index].callback);
+		_Release(index);
+		callback();
+		return;
+	}
+	m_timers[index].state = _State::Firing;
+	m_timers[index].callback();
+
+	_Timer& timer = m_timers[index];
+	if (timer.state == _State::CancelledWhileFiring) {
+		_Release(index);
+		return;
+	}
+	timer.state = _State::Scheduled;
+	timer.deadline += timer.interval;
+	if (timer.deadline <= m_currentTick) {
+		timer.deadline = m_currentTick + timer.interval;
+	}
+	_Link(index);
+}
+
+uint64_t jade::TimerWheel::_SlotEventTick(uint32_t level, uint32_t slot) const noexcept {
+	uint32_t blockShift = s_SlotBits * (level + 1);
+	uint64_t base = (m_currentTick >> blockShift) << blockShift;
+	uint64_t tick = base + ((uint64_t)slot << (s_SlotBits * level));
+
+	if (tick <= m_currentTick) {
+		tick += 1ull << blockShift;
+	}
+	return tick;
+}
+
+uint64_t jade::TimerWheel::_ComputeNextEventTick() const noexcept {
+	uint64_t nextTick = s_NoTick;
+
+	for (uint32_t level = 0; level < s_LevelCount; ++level) {
+		if (m_occupied[level] == 0) {
+			continue;
+		}
+		uint32_t current = (uint32_t)((m_currentTick >> (s_SlotBits * level)) & (s_SlotCount - 1));
+		uint32_t start = (current + 1) & (s_SlotCount - 1);
+		uint64_t rotated = std::rotr(m_occupied[level], (int)start);
+		uint32_t slot = (uint32_t)((std::countr_zero(rotated) + start) & (s_SlotCount - 1));
+
+		nextTick = std::min(nextTick, _SlotEventTick(level, slot));
+	}
+	return nextTick;
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include <jade/Trace.h>
+
+#include <fstream>
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+
+namespace {
+	struct TraceSnapshot {
+		uint64_t               timestamp;
+		const char*            name;
+		jade::TraceRecordType  type;
+	};
+
+	thread_local void* g_ThreadBuffer = nullptr;
+
+	void WriteJsonString(std::ofstream& out, const char* str) {
+		out << '"';
+		for (; *str != '\0'; ++str) {
+			if (*str == '"' || *str == '\\') {
+				out << '\\';
+			}
+			out << *str;
+		}
+		out << '"';
+	}
+
+	jade::Tracer g_Tracer;
+}
+
+jade::Tracer::Tracer() : m_epoch(std::chrono::steady_clock::now()) {}
+
+jade::Tracer& jade::Tracer::Get() noexcept { return g_Tracer; }
+
+void jade::Tracer::Record(TraceRecordType type, const char* name) noexcept {
+	_ThreadBuffer& buffer = _GetThreadBuffer();
+
+	uint64_t head = buffer.head.load(std::memory_order_relaxed);
+	_Record& record = buffer.records[head & (s_BufferCapacity - 1)];
+
+	auto elapsed = std::chrono::steady_clock::now() - m_epoch;
+	record.timestamp.store((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), std::memory_order_relaxed);
+	record.name.store(name, std::memory_order_relaxed);
+	record.type.store(type, std::memory_order_relaxed);
+
+	buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void jade::Tracer::SetThreadName(const char* name) {
+	_GetThreadBuffer().threadName.store(name, std::memory_order_relaxed);
+}
+
+void jade::Tracer::DumpChromeTrace(const std::filesystem::path& path) const {
+	std::ofstream out(path, std::ios::trunc);
+	if (!out.is_open()) {
+		throw std::runtime_error("Failed to open trace file '" + path.string() + '\'');
+	}
+	out << std::fixed << std::setprecision(3);
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool first = true;
+	auto separate = [&]() {
+		if (!first) {
+			out << ',';
+		}
+		first = false;
+	};
+
+	std::lock_guard<std::mutex> lock(m_buffersMutex);
+	std::vector<TraceSnapshot> snapshot;
+	snapshot.reserve(s_BufferCapacity);
+
+	for (const std::unique_ptr<_ThreadBuffer>& buffer : m_buffers) {
+		uint64_t head  = buffer->head.load(std::memory_order_acquire);
+		uint64_t begin = head > s_BufferCapacity ? head - s_BufferCapacity : 0;
+
+		snapshot.clear();
+		for (uint64_t i = begin; i < head; ++i) {
+			const _Record& record = buffer->records[i & (s_BufferCapacity - 1)];
+			snapshot.push_back(TraceSnapshot{
+				.timestamp = record.timestamp.load(std::memory_order_relaxed),
+				.name      = record.name.load(std::memory_order_relaxed),
+				.type      = record.type.load(std::memory_order_relaxed)
+			});
+		}
+		// Records the owning thread overwrote while they were being copied are dropped
+		uint64_t headAfter = buffer->head.load(std::memory_order_acquire);
+		size_t skip = headAfter >= begin + s_BufferCapacity ? (size_t)(headAfter - begin - s_BufferCapacity + 1) : 0;
+		skip = std::min(skip, snapshot.size());
+
+		if (const char* threadName = buffer->threadName.load(std::memory_order_relaxed)) {
+			separate();
+			out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadID << ",\"args\":{\"name\":";
+			WriteJsonString(out, threadName);
+			out << "}}";
+		}
+		// Ends whose begin fell out of the ring would close unrelated slices
+		size_t depth = 0;
+		for (size_t i = skip; i < snapshot.size(); ++i) {
+			const TraceSnapshot& record = snapshot[i];
+			const char* phase = "i";
+			if (record.type == TraceRecordType::Begin) {
+				phase = "B";
+				++depth;
+			}
+			else if (record.type == TraceRecordType::End) {
+				if (depth == 0) {
+					continue;
+				}
+				phase = "E";
+				--depth;
+			}
+			separate();
+			out << "{\"name\":";
+			WriteJsonString(out, record.name);
+			out << ",\"ph\":\"" << phase << "\",\"ts\":" << (double)record.timestamp * 1e-3
+				<< ",\"pid\":1,\"tid\":" << buffer->threadID;
+			if (record.type == TraceRecordType::Instant) {
+				out << ",\"s\":\"t\"";
+			}
+			out << '}';
+		}
+	}
+	out << "]}";
+}
+
+jade::Tracer::_ThreadBuffer& jade::Tracer::_GetThreadBuffer() {
+	if (g_ThreadBuffer != nullptr) {
+		return *(_ThreadBuffer*)g_ThreadBuffer;
+	}
+	std::lock_guard<std::mutex> lock(m_buffersMutex);
+	m_buffers.emplace_back(std::make_unique<_ThreadBuffer>());
+	m_buffers.back()->threadID = (uint32_t)m_buffers.size();
+
+	g_ThreadBuffer = m_buffers.back().get();
+	return *m_buffers.back();
+}
\ No newline at end of file
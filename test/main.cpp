@@ -0,0 +1,342 @@
+#include <jade/Event.h>
+#include <jade/EventSystem.h>
+
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <span>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <iostream>
+
+namespace {
+	using Clock = std::chrono::high_resolution_clock;
+
+	size_t g_FailedChecks = 0;
+
+	// Lets a test park a producer inside an allocation, see operator new below
+	std::atomic<bool> g_IsAllocationHeld    = false;
+	std::atomic<bool> g_IsAllocationWaiting = false;
+	thread_local bool t_HoldNextAllocation  = false;
+
+	void Check(bool condition, const char* what) {
+		if (!condition) {
+			std::cout << "  FAILED: " << what << '\n';
+			++g_FailedChecks;
+		}
+	}
+
+	// Producer index in the high half of the track id, its sequence number in the low one
+	inline uint64_t MakeTaggedID(size_t producer, size_t sequence) noexcept {
+		return ((uint64_t)producer << 32) | (uint64_t)sequence;
+	}
+
+	struct StressResult {
+		std::vector<size_t> received;  // per producer
+		size_t              reordered = 0;
+		size_t              skipped   = 0;
+		uint64_t            coalesced = 0;
+	};
+
+	// Producers push tagged events into a queue of their own while the main thread drains
+	// it through the event system, every received event is checked against the last one
+	// of the same producer.
+	template <jade::EventOverflowPolicy policy>
+	StressResult RunProducers(size_t capacity, size_t producerCount, size_t eventCount) {
+		jade::EventSystem events;
+		jade::EventSystem::ConcurrentQueue queue(capacity);
+
+		StressResult result;
+		result.received.resize(producerCount, 0);
+		std::vector<size_t> nextSequence(producerCount, 0);
+
+		events.Subscribe<jade::OnTrackStarted>(0, [&](const jade::OnTrackStarted& e) {
+			size_t producer = (size_t)(e.trackID >> 32);
+			size_t sequence = (size_t)(e.trackID & 0xFFFFFFFF);
+
+			if (sequence < nextSequence[producer]) {
+				++result.reordered;
+			}
+			else if (sequence > nextSequence[producer]) {
+				++result.skipped;
+			}
+			nextSequence[producer] = sequence + 1;
+			++result.received[producer];
+		});
+
+		std::atomic<size_t> finishedCount = 0;
+		std::vector<std::thread> producers;
+		for (size_t producer = 0; producer < producerCount; ++producer) {
+			producers.emplace_back([&, producer]() {
+				for (size_t i = 0; i < eventCount; ++i) {
+					queue.Push<jade::OnTrackStarted, policy>(jade::OnTrackStarted{ .trackID = MakeTaggedID(producer, i) });
+				}
+				finishedCount.fetch_add(1, std::memory_order_release);
+			});
+		}
+
+		// A drain that finds nothing after every producer finished has seen all events
+		for (;;) {
+			bool isFinished = finishedCount.load(std::memory_order_acquire) == producerCount;
+			size_t drained  = queue.Drain(events);
+			events.Dispatch();
+
+			if (isFinished && drained == 0) {
+				break;
+			}
+			if (drained == 0) {
+				std::this_thread::yield();
+			}
+		}
+		for (std::thread& producer : producers) {
+			producer.join();
+		}
+		result.coalesced = queue.GetCoalescedCount();
+		return result;
+	}
+
+	void TestProducersGrow() {
+		std::cout << "MPSC stress, grow\n";
+		constexpr size_t producerCount = 8, eventCount = 100000;
+
+		StressResult result = RunProducers<jade::EventOverflowPolicy::Grow>(64, producerCount, eventCount);
+		Check(result.reordered == 0, "events of one producer arrive in order");
+		Check(result.skipped == 0, "no event is lost");
+		for (size_t received : result.received) {
+			Check(received == eventCount, "every event of every producer arrives");
+		}
+	}
+
+	void TestProducersBlock() {
+		std::cout << "MPSC stress, block\n";
+		constexpr size_t producerCount = 8, eventCount = 100000;
+
+		StressResult result = RunProducers<jade::EventOverflowPolicy::Block>(64, producerCount, eventCount);
+		Check(result.reordered == 0, "events of one producer arrive in order");
+		Check(result.skipped == 0, "no event is lost");
+		for (size_t received : result.received) {
+			Check(received == eventCount, "every event of every producer arrives");
+		}
+	}
+
+	// A producer claimed the first cell of a two-cell ring but has not published it yet,
+	// another one fills the second cell and spills its next event. The spill must not be
+	// relayed ahead of the second cell.
+	void TestSpillBehindUnpublishedCell() {
+		std::cout << "Spill behind an unpublished cell\n";
+		jade::EventSystem events;
+		jade::EventSystem::ConcurrentQueue queue(2);
+
+		std::vector<uint64_t> started;
+		events.Subscribe<jade::OnTrackStarted>(0, [&started](const jade::OnTrackStarted& e) { started.push_back(e.trackID); });
+
+		// Copying the message allocates between claiming the cell and publishing it
+		jade::OnTaskEnded ended = { .errorMsg = "message longer than the small string buffer" };
+		g_IsAllocationHeld.store(true);
+
+		std::thread heldProducer([&queue, &ended]() {
+			t_HoldNextAllocation = true;
+			queue.Push<jade::OnTaskEnded>(ended);
+		});
+		while (!g_IsAllocationWaiting.load()) {
+			std::this_thread::yield();
+		}
+		queue.Push<jade::OnTrackStarted>(jade::OnTrackStarted{ .trackID = 1 });
+		queue.Push<jade::OnTrackStarted>(jade::OnTrackStarted{ .trackID = 2 });
+		queue.Drain(events);
+		events.Dispatch();
+
+		g_IsAllocationHeld.store(false);
+		heldProducer.join();
+		queue.Drain(events);
+		events.Dispatch();
+
+		Check(started.size() == 2 && started[0] == 1 && started[1] == 2, "a spilled event never overtakes an earlier one in the ring");
+	}
+
+	// Coalesced events are gone, the rest still arrives in order
+	void TestProducersCoalesce() {
+		std::cout << "MPSC stress, coalesce\n";
+		constexpr size_t producerCount = 8, eventCount = 100000;
+
+		StressResult result = RunProducers<jade::EventOverflowPolicy::Coalesce>(64, producerCount, eventCount);
+		Check(result.reordered == 0, "events of one producer arrive in order");
+
+		size_t received = 0;
+		for (size_t count : result.received) {
+			received += count;
+		}
+		Check(received + result.coalesced == producerCount * eventCount, "every event either arrives or is coalesced");
+	}
+
+	// Events emitted from worker threads through the regular path, counted once dispatched
+	void BenchmarkConcurrentEmit() {
+		std::cout << "Concurrent emit throughput\n";
+		constexpr size_t eventCount = 200000;
+
+		for (size_t producerCount : { 1, 2, 4, 8 }) {
+			jade::EventSystem events;
+			size_t received = 0;
+			events.Subscribe<jade::OnTrackStarted>(0, [&received](const jade::OnTrackStarted&) { ++received; });
+
+			size_t total = producerCount * eventCount;
+			auto startTimestamp = Clock::now();
+
+			std::vector<std::thread> producers;
+			for (size_t producer = 0; producer < producerCount; ++producer) {
+				producers.emplace_back([producer]() {
+					for (size_t i = 0; i < eventCount; ++i) {
+						jade::EventEmitter<jade::OnTrackStarted>().Emit(jade::OnTrackStarted{ .trackID = MakeTaggedID(producer, i) });
+					}
+				});
+			}
+			while (received < total) {
+				events.Dispatch();
+			}
+			double seconds = std::chrono::duration<double>(Clock::now() - startTimestamp).count();
+
+			for (std::thread& producer : producers) {
+				producer.join();
+			}
+			std::cout << "  " << producerCount << " producers: " << (uint64_t)(total / seconds) << " events/s\n";
+		}
+	}
+
+	// Dispatch cost per event with 4 subscribers over frames of 1000 main-thread events,
+	// delivered one by one or as runs to batch subscribers
+	template <bool isBatched>
+	double MeasureDispatch() {
+		constexpr size_t frameCount = 2000, eventsPerFrame = 1000, subscriberCount = 4;
+
+		jade::EventSystem events;
+		uint64_t checksum = 0;
+		for (size_t i = 0; i < subscriberCount; ++i) {
+			if constexpr (isBatched) {
+				events.SubscribeBatch<jade::OnTrackStarted>(i, [&checksum](std::span<jade::OnTrackStarted> run) {
+					for (const jade::OnTrackStarted& e : run) {
+						checksum += e.trackID;
+					}
+				});
+			}
+			else {
+				events.Subscribe<jade::OnTrackStarted>(i, [&checksum](const jade::OnTrackStarted& e) {
+					checksum += e.trackID;
+				});
+			}
+		}
+
+		Clock::duration elapsed = {};
+		for (size_t frame = 0; frame < frameCount; ++frame) {
+			for (size_t i = 0; i < eventsPerFrame; ++i) {
+				jade::EventEmitter<jade::OnTrackStarted>().Emit(jade::OnTrackStarted{ .trackID = i });
+			}
+			auto startTimestamp = Clock::now();
+			events.Dispatch();
+			elapsed += Clock::now() - startTimestamp;
+		}
+		Check(checksum == frameCount * subscriberCount * (eventsPerFrame * (eventsPerFrame - 1) / 2), "every subscriber sees every event");
+		return std::chrono::duration<double, std::nano>(elapsed).count() / (frameCount * eventsPerFrame);
+	}
+
+	// The dispatch EventSystem used before the delegates, kept as the baseline: one
+	// std::function dispatcher per event id walking std::function subscribers that wrap
+	// the user function, over the same queue of id and payload pointer pairs
+	double MeasureStdFunctionDispatch() {
+		constexpr size_t frameCount = 2000, eventsPerFrame = 1000, subscriberCount = 4;
+
+		struct Subscriber {
+			size_t                     priority = 0;
+			std::function<void(void*)> function;
+		};
+		struct QueuedEvent {
+			uint32_t id   = UINT32_MAX;
+			void*    data = nullptr;
+		};
+
+		uint64_t checksum = 0;
+		std::vector<Subscriber> subscribers;
+		for (size_t i = 0; i < subscriberCount; ++i) {
+			auto function = [&checksum](const jade::OnTrackStarted& e) { checksum += e.trackID; };
+			subscribers.push_back(Subscriber{
+				.priority = i,
+				.function = [function](void* data) { function(*(jade::OnTrackStarted*)data); }
+			});
+		}
+		std::vector<std::function<void(void*)>> dispatchers = {
+			[&subscribers](void* data) {
+				for (const Subscriber& subscriber : subscribers) {
+					subscriber.function(data);
+				}
+			}
+		};
+
+		std::vector<jade::OnTrackStarted> payloads(eventsPerFrame);
+		std::vector<QueuedEvent> queue;
+		queue.reserve(eventsPerFrame);
+
+		Clock::duration elapsed = {};
+		for (size_t frame = 0; frame < frameCount; ++frame) {
+			for (size_t i = 0; i < eventsPerFrame; ++i) {
+				payloads[i].trackID = i;
+				queue.push_back(QueuedEvent{ .id = 0, .data = &payloads[i] });
+			}
+			auto startTimestamp = Clock::now();
+			for (size_t i = 0; i < queue.size(); ++i) {
+				QueuedEvent event = queue[i];
+				dispatchers[event.id](event.data);
+			}
+			queue.clear();
+			elapsed += Clock::now() - startTimestamp;
+		}
+		Check(checksum == frameCount * subscriberCount * (eventsPerFrame * (eventsPerFrame - 1) / 2), "every std::function subscriber sees every event");
+		return std::chrono::duration<double, std::nano>(elapsed).count() / (frameCount * eventsPerFrame);
+	}
+
+	void BenchmarkDispatch() {
+		std::cout << "Dispatch, 1000 events per frame, 4 subscribers\n";
+		std::cout << "  std::function: " << MeasureStdFunctionDispatch() << " ns/event\n";
+		std::cout << "  per event:     " << MeasureDispatch<false>() << " ns/event\n";
+		std::cout << "  batched:       " << MeasureDispatch<true>() << " ns/event\n";
+	}
+}
+
+void* operator new(size_t size) {
+	if (t_HoldNextAllocation) {
+		t_HoldNextAllocation = false;
+		g_IsAllocationWaiting.store(true);
+		while (g_IsAllocationHeld.load()) {
+			std::this_thread::yield();
+		}
+	}
+	if (void* memory = std::malloc(size != 0 ? size : 1)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+	std::free(memory);
+}
+
+int main() {
+	TestProducersGrow();
+	TestProducersBlock();
+	TestProducersCoalesce();
+	TestSpillBehindUnpublishedCell();
+	BenchmarkConcurrentEmit();
+	BenchmarkDispatch();
+
+	if (g_FailedChecks != 0) {
+		std::cout << g_FailedChecks << " checks failed\n";
+		return 1;
+	}
+	std::cout << "All checks passed\n";
+	return 0;
+}
\ No newline at end of file